@@ -6,11 +6,15 @@
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <memory>
+#include <unistd.h>
+#include <stdint.h>
 
 #include <mpi.h>
 
 #include "../src/Defs.hpp"
 #include "../src/Simulator.hpp"
+#include "../src/Problem.hpp"
 
 #define SIZE 4
 #define INPUT 1
@@ -167,6 +171,16 @@ void child_process(double start, double end, double rate, int iter, int reject,
       numSimulation = 10;
    }
 
+   /*
+    * read the input once, every job shares the same problem
+    */
+   shared_ptr<Problem> problem(new Problem());
+   int loadErr = problem->load(inputFile);
+   if (loadErr == NO_ERR && !problem->isBandwidthExact()) {
+      cerr << "# Bandwidth rounded to units of 1/"
+            << problem->getNetlist().getScale() << endl;
+   }
+
    /*
     * receive parameters setting from root process
     */
@@ -180,23 +194,30 @@ void child_process(double start, double end, double rate, int iter, int reject,
        * receive seed setting from root process
        */
       MPI_Recv(&seed, 1, MPI_UNSIGNED, ROOT, SEED, MPI_COMM_WORLD, &status);
-      /*
-       * seed random number generator
-       */
-      srand(seed);
 
       sumRatio = 0;
 
       stringstream s;
       for (int i = 0; i < numSimulation; i++) {
          Simulator sa;
-         int err = sa.init(param[ALPHA_INDEX], param[BETA_INDEX],
-               param[GAMMA_INDEX], param[DELTA_INDEX], start, end, rate, iter,
-               reject, accept, inputFile, verbose, quiet);
+         int err = loadErr;
+         if (err == NO_ERR) {
+            err = sa.init(param[ALPHA_INDEX], param[BETA_INDEX],
+                  param[GAMMA_INDEX], param[DELTA_INDEX], start, end, rate,
+                  iter, reject, accept, problem, verbose, quiet);
+            /*
+             * every simulation of a job runs its own stream of the seed
+             */
+            sa.setSeed(seed, i);
+         }
          if (err == FILE_OPEN_ERR) {
             s << "# File open error exit" << endl;
          } else if (err == ILLEGAL_STATE_ERR) {
             s << "# Illegal initial state" << endl;
+         } else if (err == INPUT_ERR) {
+            s << "# Invalid input file exit" << endl;
+         } else if (err == CONNECTION_ERR) {
+            s << "# More than " << INT16_MAX << " connections exit" << endl;
          } else {
             /*
              * start simulated annealing
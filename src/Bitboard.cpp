@@ -0,0 +1,76 @@
+#include "Bitboard.hpp"
+
+using namespace std;
+
+Bitboard::Bitboard() {
+   numBit = 0;
+   numSet = 0;
+}
+
+Bitboard::~Bitboard() {
+}
+
+void Bitboard::init(int size) {
+   numBit = size;
+   numSet = 0;
+   words = vector<uint64_t> ((size + 63) / 64, 0);
+}
+
+int Bitboard::rank(int i) const {
+   int r = 0;
+   int w = i >> 6;
+   for (int k = 0; k < w; k++) {
+      r += __builtin_popcountll(words[k]);
+   }
+   //bits of word w below bit i
+   if (i & 63) {
+      r += __builtin_popcountll(words[w] & (((uint64_t) 1 << (i & 63)) - 1));
+   }
+   return r;
+}
+
+int Bitboard::select(int k) const {
+   assert(k >= 0 && k < numSet);
+   for (unsigned int w = 0; w < words.size(); w++) {
+      int n = __builtin_popcountll(words[w]);
+      if (k < n) {
+         return (w << 6) + selectInWord(words[w], k);
+      }
+      k -= n;
+   }
+   return -1;
+}
+
+int Bitboard::selectZero(int k) const {
+   assert(k >= 0 && k < numBit - numSet);
+   for (unsigned int w = 0; w < words.size(); w++) {
+      //bits past the last node are never in the set, they are left out
+      uint64_t zeros = ~words[w];
+      if ((int) (w << 6) + 64 > numBit) {
+         zeros &= ((uint64_t) 1 << (numBit & 63)) - 1;
+      }
+      int n = __builtin_popcountll(zeros);
+      if (k < n) {
+         return (w << 6) + selectInWord(zeros, k);
+      }
+      k -= n;
+   }
+   return -1;
+}
+
+int Bitboard::selectInWord(uint64_t word, int k) {
+   //skip whole bytes, then drop the lowest set bits one at a time
+   int base = 0;
+   int n = __builtin_popcountll(word & 0xff);
+   while (k >= n) {
+      k -= n;
+      word >>= 8;
+      base += 8;
+      n = __builtin_popcountll(word & 0xff);
+   }
+   while (k > 0) {
+      word &= word - 1;
+      k--;
+   }
+   return base + __builtin_ctzll(word);
+}
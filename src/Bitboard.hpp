@@ -0,0 +1,80 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <stdint.h>
+#include <vector>
+#include <cassert>
+
+using std::vector;
+
+/*
+ * Set of nodes of a mesh, one bit per node
+ * The number of nodes in the set is kept, so that the k-th node in or out
+ * of the set is found with a popcount per 64 nodes and a search in a word.
+ */
+class Bitboard {
+   public:
+      Bitboard();
+      ~Bitboard();
+
+      /*
+       * initialize an empty set of "size" nodes
+       */
+      void init(int size);
+      /*
+       * add/remove node "i" to/from the set
+       */
+      void set(int i, bool value);
+      /*
+       * check if node "i" is in the set
+       */
+      bool test(int i) const;
+      /*
+       * get number of nodes / number of nodes in the set
+       */
+      int size() const;
+      int count() const;
+      /*
+       * number of nodes in the set before node "i"
+       */
+      int rank(int i) const;
+      /*
+       * get the k-th node in the set / out of the set, k counts from 0
+       */
+      int select(int k) const;
+      int selectZero(int k) const;
+
+   private:
+      int numBit;
+      int numSet;
+      vector<uint64_t> words;
+
+      /*
+       * position of the k-th set bit of "word"
+       */
+      static int selectInWord(uint64_t word, int k);
+};
+
+inline void Bitboard::set(int i, bool value) {
+   assert(i >= 0 && i < numBit);
+   uint64_t bit = (uint64_t) 1 << (i & 63);
+   uint64_t& word = words[i >> 6];
+   if (((word & bit) != 0) != value) {
+      word ^= bit;
+      numSet += value ? 1 : -1;
+   }
+}
+
+inline bool Bitboard::test(int i) const {
+   return (words[i >> 6] >> (i & 63)) & 1;
+}
+
+inline int Bitboard::size() const {
+   return numBit;
+}
+
+inline int Bitboard::count() const {
+   return numSet;
+}
+
+#endif
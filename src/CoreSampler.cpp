@@ -0,0 +1,56 @@
+#include <cassert>
+
+#include "CoreSampler.hpp"
+
+using namespace std;
+
+CoreSampler::CoreSampler() {
+   total = 0;
+   step = 0;
+}
+
+CoreSampler::~CoreSampler() {
+}
+
+void CoreSampler::init(int size) {
+   weight = vector<long long> (size);
+   tree = vector<long long> (size + 1);
+   total = 0;
+   step = 1;
+   while (step * 2 <= size) {
+      step *= 2;
+   }
+}
+
+void CoreSampler::set(int index, long long w) {
+   assert(w >= 0);
+   long long change = w - weight[index];
+   if (change == 0) {
+      return;
+   }
+   weight[index] = w;
+   total += change;
+   for (int i = index + 1; i < (int) tree.size(); i += i & (-i)) {
+      tree[i] += change;
+   }
+}
+
+int CoreSampler::sample(RandomGenerator& random) const {
+   assert(total > 0);
+   long long r = (long long) (random.uniform_0_1() * total);
+   if (r >= total) {
+      r = total - 1;
+   }
+   /*
+    * descend the tree to the last index whose prefix sum is not above r,
+    * the core after it holds r
+    */
+   int pos = 0;
+   for (int s = step; s > 0; s >>= 1) {
+      if (pos + s < (int) tree.size() && tree[pos + s] <= r) {
+         pos += s;
+         r -= tree[pos];
+      }
+   }
+   return pos;
+}
@@ -0,0 +1,55 @@
+#ifndef CORESAMPLER_HPP
+#define CORESAMPLER_HPP
+
+#include <vector>
+
+#include "Defs.hpp"
+#include "RandomGenerator.hpp"
+
+using std::vector;
+
+/*
+ * Random selection of cores with probability proportional to their weight
+ * Weights are integers kept in a Fenwick tree, so that changing a weight
+ * and selecting a core take O(log number of cores) and the sums never drift.
+ */
+class CoreSampler {
+   public:
+      CoreSampler();
+      ~CoreSampler();
+
+      /*
+       * initialize "size" cores with zero weight
+       */
+      void init(int size);
+      /*
+       * set weight of core[index] to "w"
+       */
+      void set(int index, long long w);
+      /*
+       * get sum of the weights of every core
+       */
+      long long getTotal() const;
+      /*
+       * randomly select a core, the total weight must not be zero
+       */
+      int sample(RandomGenerator& random) const;
+
+   private:
+      vector<long long> weight;
+      /*
+       * Fenwick tree of the weights, tree index is core index + 1
+       */
+      vector<long long> tree;
+      long long total;
+      /*
+       * largest power of two not above the number of cores
+       */
+      int step;
+};
+
+inline long long CoreSampler::getTotal() const {
+   return total;
+}
+
+#endif
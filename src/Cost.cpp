@@ -2,6 +2,8 @@
 #include <iomanip>
 #include <cmath>
 #include <sstream>
+#include <cstdlib>
+#include <algorithm>
 
 #include "Defs.hpp"
 #include "Cost.hpp"
@@ -10,6 +12,10 @@
 using namespace std;
 
 Cost::Cost() {
+   terms = ALL_TERMS;
+   evaluatedTerms = ALL_TERMS;
+   evaluateFunction = getEvaluateFunction(ALL_TERMS);
+   scale = FIXED_POINT_SCALE;
 }
 
 Cost::~Cost() {
@@ -21,235 +27,493 @@ void Cost::init(double alpha, double beta, double gamma, double delta) {
    this->gamma = gamma;
    this->delta = delta;
 
+   /*
+    * a term with zero weight does not change the cost of a move
+    * so it is not evaluated
+    */
+   terms = 0;
+   if (alpha != 0) {
+      terms |= COMPACTION_TERM;
+   }
+   if ((1 - alpha) * beta != 0) {
+      terms |= SLACK_TERM;
+   }
+   if ((1 - alpha) * gamma != 0) {
+      terms |= PROXIMITY_TERM;
+   }
+   if ((1 - alpha) * delta != 0) {
+      terms |= UTILIZATION_TERM;
+   }
+   evaluatedTerms = terms;
+   evaluateFunction = getEvaluateFunction(terms);
+}
+
+void Cost::setEvaluateAll(bool enable) {
+   evaluatedTerms = enable ? ALL_TERMS : terms;
+   evaluateFunction = getEvaluateFunction(evaluatedTerms);
+}
+
+bool Cost::isUtilizationEvaluated() const {
+   return (evaluatedTerms & UTILIZATION_TERM) != 0;
+}
+
+Cost::EvaluateFunction Cost::getEvaluateFunction(int terms) {
+   static const EvaluateFunction function[ALL_TERMS + 1] = {
+      &Cost::evaluate<0>, &Cost::evaluate<1>, &Cost::evaluate<2>,
+      &Cost::evaluate<3>, &Cost::evaluate<4>, &Cost::evaluate<5>,
+      &Cost::evaluate<6>, &Cost::evaluate<7>, &Cost::evaluate<8>,
+      &Cost::evaluate<9>, &Cost::evaluate<10>, &Cost::evaluate<11>,
+      &Cost::evaluate<12>, &Cost::evaluate<13>, &Cost::evaluate<14>,
+      &Cost::evaluate<15>
+   };
+   return function[terms];
 }
 
 double Cost::getCost() const {
    return cost;
 }
 
-void Cost::initCost(vector<vector<double> > &bandwidth,
-      vector<vector<double> > &latency, vector<Core> &core,
+void Cost::initCost(const Netlist &netlist, vector<Core> &core,
       const double LINK_LATENCY, Network& network) {
-   compaction = initCompaction(bandwidth, core);
-   dilation = initDilation(bandwidth, latency, core, LINK_LATENCY, network);
-   cost = alpha * compaction + (1 - alpha) * dilation;
+   initTerms(netlist, core, LINK_LATENCY, network);
    initialCost = cost;
 }
 
-double Cost::initCompaction(vector<vector<double> > &bandwidth,
-      vector<Core> &core) {
-   double sum = 0;
-   for (unsigned int i = 0; i < core.size(); i++) {
-      for (unsigned int j = 0; j < core.size(); j++) {
-         if (bandwidth[i][j] != 0) {
-            sum += bandwidth[i][j] * getHops(core[i].getPosition(),
-                  core[j].getPosition());
-         }
-      }
+double Cost::recalculateCost(const Netlist &netlist, vector<Core> &core,
+      const double LINK_LATENCY, Network& network) {
+   double tracked[5] = { compaction, slack, proximity, utilization, cost };
+   initTerms(netlist, core, LINK_LATENCY, network);
+   double fresh[5] = { compaction, slack, proximity, utilization, cost };
+
+   double drift = 0;
+   for (int i = 0; i < 5; i++) {
+      drift = max(drift, fabs(tracked[i] - fresh[i]));
    }
-   return sum;
+   return drift;
 }
 
-double Cost::initDilation(vector<vector<double> > &bandwidth, vector<vector<
-      double> > &latency, vector<Core> &core, const double LINK_LATENCY,
-      Network& network) {
-   slack = initSlack(latency, core, LINK_LATENCY);
-   proximity = initProximity(bandwidth, core);
-   utilization = utilizationCost(bandwidth, core, network);
-   return beta * slack + gamma * proximity + delta * utilization;
+void Cost::initTerms(const Netlist &netlist, vector<Core> &core,
+      const double LINK_LATENCY, Network& network) {
+   scale = netlist.getScale();
+   distance.init(network.getRow(), network.getCol());
+   initConnectionTerms(netlist, core);
+   proximitySum = initProximity(netlist, core);
+   setTerms(LINK_LATENCY);
+   dilation = initDilation(netlist, core, LINK_LATENCY, network);
+   cost = alpha * compaction + (1 - alpha) * dilation;
 }
 
-double Cost::initSlack(vector<vector<double> > &latency, vector<Core> &core,
-      const double LINK_LATENCY) {
-   double sum = 0;
-   int hops;
-   for (unsigned int i = 0; i < core.size(); i++) {
-      for (unsigned int j = 0; j < core.size(); j++) {
-         if (latency[i][j] != 0) {
-            hops = getHops(core[i].getPosition(), core[j].getPosition());
-            sum += latency[i][j] - hops * LINK_LATENCY;
-         }
+void Cost::setTerms(const double LINK_LATENCY) {
+   compaction = (double) compactionSum / scale;
+   slack = latencySum - slackHops * LINK_LATENCY;
+   proximity = (double) proximitySum;
+}
+
+void Cost::initConnectionTerms(const Netlist &netlist,
+      const vector<Core> &core) {
+   int numCore = core.size();
+   int numConnection = netlist.getNumConnection();
+   int k = 0;
+
+   /*
+    * end points, bandwidth and latency flag of every connection are
+    * gathered once into separate arrays, so that the hops are summed
+    * by a branch-free loop over contiguous arrays
+    * a connection without bandwidth adds nothing to compaction
+    * and a connection without latency adds nothing to slack
+    */
+   connectionDx.resize(numConnection);
+   connectionDy.resize(numConnection);
+   connectionBandwidth.resize(numConnection);
+   connectionConstrained.resize(numConnection);
+   int* dx = connectionDx.data();
+   int* dy = connectionDy.data();
+   long long* bandwidth = connectionBandwidth.data();
+   long long* constrained = connectionConstrained.data();
+   latencySum = 0;
+   for (int i = 0; i < numCore; i++) {
+      Coordinate pos = core[i].getPosition();
+      for (; k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         Coordinate peer = core[c.peer].getPosition();
+         dx[k] = pos.x - peer.x;
+         dy[k] = pos.y - peer.y;
+         bandwidth[k] = c.fixedBandwidth;
+         constrained[k] = (c.latency != 0);
+         latencySum += c.latency;
       }
    }
-   return sum;
+
+   /*
+    * blocks of HOP_BLOCK connections have a fixed trip count
+    * and are vectorized, the remaining connections are summed one by one
+    */
+   long long compaction[HOP_BLOCK] = { 0 };
+   long long slack[HOP_BLOCK] = { 0 };
+   long long hops;
+   for (k = 0; k + HOP_BLOCK <= numConnection; k += HOP_BLOCK) {
+      for (int j = 0; j < HOP_BLOCK; j++) {
+         hops = abs(dx[k + j]) + abs(dy[k + j]);
+         compaction[j] += bandwidth[k + j] * hops;
+         slack[j] += constrained[k + j] * hops;
+      }
+   }
+   compactionSum = 0;
+   slackHops = 0;
+   for (int j = 0; j < HOP_BLOCK; j++) {
+      compactionSum += compaction[j];
+      slackHops += slack[j];
+   }
+   for (; k < numConnection; k++) {
+      hops = abs(dx[k]) + abs(dy[k]);
+      compactionSum += bandwidth[k] * hops;
+      slackHops += constrained[k] * hops;
+   }
 }
 
-double Cost::initProximity(vector<vector<double> > &bandwidth,
-      vector<Core> &core) {
-   double sum = 0;
+double Cost::initDilation(const Netlist &netlist, vector<Core> &core,
+      const double LINK_LATENCY, Network& network) {
+   utilization = utilizationCost(netlist, core, network);
+   return beta * slack + gamma * proximity + delta * utilization;
+}
+
+long long Cost::initProximity(const Netlist &netlist, vector<Core> &core) {
+   long long sum = 0;
    int dist;
+   /*
+    * proximity of every pair of cores
+    * minus the pairs that are connected
+    * each core is paired with the cores added before it
+    */
    for (unsigned int i = 0; i < core.size(); i++) {
-      for (unsigned int j = i + 1; j < core.size(); j++) {
-         //check that there are no connections between core i and core j
-         if ((bandwidth[i][j] == 0) && (bandwidth[j][i] == 0)) {
+      sum -= distance.getSum(core[i].getPosition());
+      distance.add(core[i].getPosition());
+      for (int k = netlist.neighbourBegin(i); k < netlist.neighbourEnd(i); k++) {
+         unsigned int j = netlist.getNeighbour(k);
+         if (j > i) {
             dist = getHops(core[i].getPosition(), core[j].getPosition());
-            sum -= dist;
+            sum += dist;
          }
       }
    }
    return sum;
 }
 
-double Cost::utilizationCost(vector<vector<double> > &bandwidth,
-      vector<Core> &core, Network& network) {
-   network.updateUtilization(bandwidth, core);
+double Cost::utilizationCost(const Netlist &netlist, vector<Core> &core,
+      Network& network) {
+   network.updateUtilization(netlist, core);
    return network.calculateUtilization();
 }
 
-void Cost::calculateCost(vector<vector<double> > &bandwidth,
-      vector<Core> &core, Network& network) {
-   utilization = utilizationCost(bandwidth, core, network);
+void Cost::calculateCost(const Network& network) {
+   utilization = network.getUtilization();
    dilation = beta * slack + gamma * proximity + delta * utilization;
    cost = alpha * compaction + (1 - alpha) * dilation;
 }
 
-void Cost::updateCost(vector<vector<double> > &bandwidth,
-      vector<vector<double> > &latency, double LINK_LATENCY,
-      vector<Core> &core, int op, int coreA, int coreB) {
-   if (op == REMOVE) {
-      compaction -= changeCompaction(bandwidth, core, coreA, coreB);
-      slack -= changeSlack(latency, LINK_LATENCY, core, coreA, coreB);
-      proximity -= changeProximity(bandwidth, core, coreA, coreB);
-   } else {
-      compaction += changeCompaction(bandwidth, core, coreA, coreB);
-      slack += changeSlack(latency, LINK_LATENCY, core, coreA, coreB);
-      proximity += changeProximity(bandwidth, core, coreA, coreB);
-   }
+void Cost::saveSnapshot(CostSnapshot& snapshot) const {
+   snapshot.compactionSum = compactionSum;
+   snapshot.slackHops = slackHops;
+   snapshot.latencySum = latencySum;
+   snapshot.proximitySum = proximitySum;
+   snapshot.utilization = utilization;
+   snapshot.cost = cost;
+   snapshot.initialCost = initialCost;
 }
 
-double Cost::changeCompaction(vector<vector<double> > &bandwidth,
-      vector<Core> &core, int coreA, int coreB) {
-   double change = 0;
+void Cost::loadSnapshot(const CostSnapshot& snapshot,
+      const vector<Core> &core, double LINK_LATENCY, const Network& network) {
+   compactionSum = snapshot.compactionSum;
+   slackHops = snapshot.slackHops;
+   latencySum = snapshot.latencySum;
+   proximitySum = snapshot.proximitySum;
+   initialCost = snapshot.initialCost;
+   setTerms(LINK_LATENCY);
+   distance.init(network.getRow(), network.getCol());
    for (unsigned int i = 0; i < core.size(); i++) {
-      /*
-       * calculate compaction cost of connection from/to coreA
-       * but do not calculate cost of connection between coreA and coreB
-       * to prevent calculating duplicates
-       */
-      if ((int) i != coreB) {
-         //connection from coreA to node i
-         change += bandwidth[coreA][i] * getHops(core[coreA].getPosition(),
-               core[i].getPosition());
-         //connection from node i to coreA
-         change += bandwidth[i][coreA] * getHops(core[i].getPosition(),
-               core[coreA].getPosition());
-      }
-      /*
-       * calculate compaction cost of connection from/to coreB
-       */
-      if (coreB != NO_CORE && (int) i != coreA) {
-         //connection from coreB to node i
-         change += bandwidth[coreB][i] * getHops(core[coreB].getPosition(),
-               core[i].getPosition());
-         //connection from node i to coreB
-         change += bandwidth[i][coreB] * getHops(core[i].getPosition(),
-               core[coreB].getPosition());
-      }
+      distance.add(core[i].getPosition());
    }
-   /*
-    * calculate cost of connection between coreA and coreB
-    */
+   calculateCost(network);
+}
+
+void Cost::updateCost(const Netlist &netlist, double LINK_LATENCY,
+      const vector<Core> &core, int coreA, Coordinate newPosA, int coreB,
+      Coordinate newPosB) {
+   TermChange change;
+   //every term is kept up to date so that the cost can be printed
+   evaluateTerms<ALL_TERMS>(netlist, core, coreA, newPosA, coreB, newPosB,
+         change);
+   compactionSum += change.compaction;
+   slackHops += change.slackHops;
+   proximitySum += change.proximity;
+   setTerms(LINK_LATENCY);
+
+   //move the cores in the distance sums
+   distance.remove(core[coreA].getPosition());
+   distance.add(newPosA);
    if (coreB != NO_CORE) {
-      //connection from coreB to node i
-      change += bandwidth[coreA][coreB] * getHops(core[coreA].getPosition(),
-            core[coreB].getPosition());
-      //connection from node i to coreB
-      change += bandwidth[coreB][coreA] * getHops(core[coreB].getPosition(),
-            core[coreB].getPosition());
+      distance.remove(core[coreB].getPosition());
+      distance.add(newPosB);
    }
-   return change;
 }
 
-double Cost::changeSlack(vector<vector<double> > &latency,
-      const double LINK_LATENCY, vector<Core> &core, int coreA, int coreB) {
-   double change = 0;
-   int hops;
-   for (unsigned int i = 0; i < core.size(); i++) {
-      /*
-       * calculate slack cost of connection from/to coreA
-       * but do not calculate cost of connection between coreA and coreB
-       * to prevent calculating duplicates
-       */
-      if ((int) i != coreB) {
-         //connection from index to node i
-         if (latency[coreA][i] != 0) {
-            hops = getHops(core[coreA].getPosition(), core[i].getPosition());
-            change += latency[coreA][i] - hops * LINK_LATENCY;
+CostDelta Cost::evaluateMove(const Netlist &netlist, double LINK_LATENCY,
+      const vector<Core> &core, const Network& network, int coreA,
+      Coordinate newPos, double threshold, PlacementCost* placement) const {
+   return (this->*evaluateFunction)(netlist, LINK_LATENCY, core, network,
+         coreA, newPos, NO_CORE, newPos, threshold, placement);
+}
+
+CostDelta Cost::evaluateSwap(const Netlist &netlist, double LINK_LATENCY,
+      const vector<Core> &core, const Network& network, int coreA,
+      int coreB, double threshold, PlacementCost* placement) const {
+   return (this->*evaluateFunction)(netlist, LINK_LATENCY, core, network,
+         coreA, core[coreB].getPosition(), coreB, core[coreA].getPosition(),
+         threshold, placement);
+}
+
+CoreTerms Cost::getCoreTerms(const Netlist &netlist,
+      const vector<Core> &core, int index) const {
+   CoreTerms terms = { 0, 0, 0 };
+   Coordinate pos = core[index].getPosition();
+   int dist;
+   for (int m = 0; m < 2; m++) {
+      int begin = (m == 0) ? netlist.outBegin(index) : netlist.inBegin(index);
+      int end = (m == 0) ? netlist.outEnd(index) : netlist.inEnd(index);
+      for (int k = begin; k < end; k++) {
+         const Connection& c = (m == 0) ? netlist.getOut(k) : netlist.getIn(k);
+         if (c.peer == index) {
+            continue;
          }
-         //connection from node i to index
-         if (latency[i][coreA] != 0) {
-            hops = getHops(core[i].getPosition(), core[coreA].getPosition());
-            change += latency[i][coreA] - hops * LINK_LATENCY;
+         dist = getHops(pos, core[c.peer].getPosition());
+         terms.hops += c.fixedBandwidth * dist;
+         if (c.latency != 0) {
+            terms.slackHops += dist;
+            terms.latency += c.latency;
          }
       }
+   }
+   return terms;
+}
+
+double Cost::getCoreCost(const CoreTerms& terms, double LINK_LATENCY) const {
+   return alpha * terms.hops / scale + (1 - alpha) * beta
+         * (terms.latency - terms.slackHops * LINK_LATENCY);
+}
+
+CostDelta Cost::evaluatePlacement(const PlacementCost& placement,
+      double LINK_LATENCY) const {
+   CostDelta change;
+   /*
+    * the integer sums give exactly the changes evaluate would find,
+    * terms that are not evaluated do not change
+    */
+   change.compaction = 0;
+   change.slack = 0;
+   change.proximity = 0;
+   change.utilization = 0;
+   if (evaluatedTerms & COMPACTION_TERM) {
+      change.compaction = (double) (placement.compactionSum - compactionSum)
+            / scale;
+   }
+   if (evaluatedTerms & SLACK_TERM) {
+      change.slack = -(placement.slackHops - slackHops) * LINK_LATENCY;
+   }
+   if (evaluatedTerms & PROXIMITY_TERM) {
+      change.proximity = (double) (placement.proximitySum - proximitySum);
+   }
+   if (evaluatedTerms & UTILIZATION_TERM) {
+      change.utilization = placement.utilization - utilization;
+   }
+   change.cost = alpha * change.compaction + (1 - alpha) * (beta
+         * change.slack + gamma * change.proximity + delta
+         * change.utilization);
+   change.bound = false;
+   return change;
+}
+
+template<int TERMS>
+CostDelta Cost::evaluate(const Netlist &netlist, double LINK_LATENCY,
+      const vector<Core> &core, const Network& network, int coreA,
+      Coordinate newPosA, int coreB, Coordinate newPosB,
+      double threshold, PlacementCost* placement) const {
+   CostDelta change;
+   TermChange term;
+   double newUtilization = utilization;
+   evaluateTerms<TERMS>(netlist, core, coreA, newPosA, coreB, newPosB, term);
+   change.compaction = (double) term.compaction / scale;
+   change.slack = -term.slackHops * LINK_LATENCY;
+   change.proximity = (double) term.proximity;
+   change.utilization = 0;
+   change.bound = false;
+   if (TERMS & UTILIZATION_TERM) {
       /*
-       * calculate slack cost of connection from/to coreB
+       * re-tracing the routes is the most expensive part,
+       * it is skipped when even the largest possible drop in
+       * utilization cannot bring the change below the threshold
        */
-      if (coreB != NO_CORE && (int) i != coreA) {
-         //connection from index to node i
-         if (latency[coreB][i] != 0) {
-            hops = getHops(core[coreB].getPosition(), core[i].getPosition());
-            change += latency[coreB][i] - hops * LINK_LATENCY;
-         }
-         //connection from node i to index
-         if (latency[i][coreB] != 0) {
-            hops = getHops(core[i].getPosition(), core[coreB].getPosition());
-            change += latency[i][coreB] - hops * LINK_LATENCY;
+      if ((1 - alpha) * delta > 0 && threshold != HUGE_VAL) {
+         change.utilization = network.evaluateUtilizationBound(netlist, core,
+               coreA, coreB);
+         change.cost = alpha * change.compaction + (1 - alpha) * (beta
+               * change.slack + gamma * change.proximity + delta
+               * change.utilization);
+         if (change.cost >= threshold) {
+            change.bound = true;
+            return change;
          }
       }
+      newUtilization = network.evaluateUtilization(netlist, core, coreA,
+            newPosA, coreB, newPosB);
+      change.utilization = newUtilization - utilization;
+   }
+
+   change.cost = alpha * change.compaction + (1 - alpha) * (beta
+         * change.slack + gamma * change.proximity + delta
+         * change.utilization);
+   if (placement != NULL) {
+      placement->compactionSum = compactionSum + term.compaction;
+      placement->slackHops = slackHops + term.slackHops;
+      placement->proximitySum = proximitySum + term.proximity;
+      placement->utilization = newUtilization;
    }
+   return change;
+}
+
+template<int TERMS>
+void Cost::evaluateTerms(const Netlist &netlist, const vector<Core> &core,
+      int coreA, Coordinate newPosA, int coreB, Coordinate newPosB,
+      TermChange &change) const {
    /*
-    * calculate slack cost of connections between coreA and coreB
+    * change = cost at the new positions - cost at the old positions
+    * every term is taken in a single pass over the moved cores
     */
-   if (coreB != NO_CORE) {
-      if (latency[coreA][coreB] != 0) {
-         hops = getHops(core[coreA].getPosition(), core[coreB].getPosition());
-         change += latency[coreA][coreB] - hops * LINK_LATENCY;
-      }
-      if (latency[coreB][coreA] != 0) {
-         hops = getHops(core[coreB].getPosition(), core[coreA].getPosition());
-         change += latency[coreB][coreA] - hops * LINK_LATENCY;
-      }
+   change.compaction = 0;
+   change.slackHops = 0;
+   change.proximity = 0;
+   if (TERMS & (COMPACTION_TERM | SLACK_TERM)) {
+      changeConnections<TERMS>(netlist, core, coreA, newPosA, coreB, newPosB,
+            change);
+   }
+   if (TERMS & PROXIMITY_TERM) {
+      change.proximity = changeProximity(netlist, core, coreA, newPosA,
+            coreB, newPosB);
    }
-
-   return change;
 }
 
-double Cost::changeProximity(vector<vector<double> > &bandwidth,
-      vector<Core> &core, int coreA, int coreB) {
-   double change = 0;
-   int dist;
-   for (unsigned int i = 0; i < core.size(); i++) {
-      /*
-       * calculate proximity cost of connection from/to core A
-       * do not calculate proximity cost between coreA and coreB
-       * to prevent calculating duplicates
-       */
-      if ((int) i != coreB) {
-         if (bandwidth[coreA][i] == 0 && bandwidth[i][coreA] == 0) {
-            dist = getHops(core[i].getPosition(), core[coreA].getPosition());
-            change -= dist;
+template<int TERMS>
+void Cost::changeConnections(const Netlist &netlist, const vector<Core> &core,
+      int coreA, Coordinate newPosA, int coreB, Coordinate newPosB,
+      TermChange &change) const {
+   int moved[2] = { coreA, coreB };
+   Coordinate newPos[2] = { newPosA, newPosB };
+   Coordinate oldPos[2];
+   oldPos[0] = core[coreA].getPosition();
+   oldPos[1] = (coreB != NO_CORE) ? core[coreB].getPosition() : oldPos[0];
+   Coordinate peerOld, peerNew;
+   int diff;
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE) {
+         continue;
+      }
+      //connection from the moved core to core "peer"
+      for (int k = netlist.outBegin(moved[m]); k < netlist.outEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.peer == moved[m]) {
+            continue;
+         }
+         /*
+          * connection between coreA and coreB is calculated
+          * once from the out list of each of them,
+          * both of its ends are moved
+          */
+         if (c.peer == coreA) {
+            peerOld = oldPos[0];
+            peerNew = newPos[0];
+         } else if (c.peer == coreB) {
+            peerOld = oldPos[1];
+            peerNew = newPos[1];
+         } else {
+            peerOld = core[c.peer].getPosition();
+            peerNew = peerOld;
+         }
+         diff = getHops(newPos[m], peerNew) - getHops(oldPos[m], peerOld);
+         if (TERMS & COMPACTION_TERM) {
+            change.compaction += c.fixedBandwidth * diff;
+         }
+         if ((TERMS & SLACK_TERM) && c.latency != 0) {
+            change.slackHops += diff;
          }
       }
-      /*
-       * calculate proximity cost of connection from/to core B
-       */
-      if (coreB != NO_CORE && (int) i != coreA) {
-         if (bandwidth[coreB][i] == 0 && bandwidth[i][coreB] == 0) {
-            dist = getHops(core[i].getPosition(), core[coreB].getPosition());
-            change -= dist;
+      //connection from core "peer" to the moved core
+      for (int k = netlist.inBegin(moved[m]); k < netlist.inEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getIn(k);
+         if (c.peer == coreA || c.peer == coreB) {
+            continue;
+         }
+         peerOld = core[c.peer].getPosition();
+         diff = getHops(peerOld, newPos[m]) - getHops(peerOld, oldPos[m]);
+         if (TERMS & COMPACTION_TERM) {
+            change.compaction += c.fixedBandwidth * diff;
+         }
+         if ((TERMS & SLACK_TERM) && c.latency != 0) {
+            change.slackHops += diff;
          }
       }
    }
+}
+
+long long Cost::changeProximity(const Netlist &netlist,
+      const vector<Core> &core, int coreA, Coordinate newPosA, int coreB,
+      Coordinate newPosB) const {
+   long long change = 0;
    /*
-    * calculate proximity cost of connection between coreA and core B
+    * proximity to every other core
+    * the distance sums hold the current positions of coreA and coreB
+    * so they are taken out, proximity cost between coreA and coreB
+    * is calculated separately to prevent calculating duplicates
     */
+   Coordinate curA = core[coreA].getPosition();
+   change -= distance.getSum(newPosA) - getHops(curA, newPosA);
+   change += distance.getSum(curA);
+   Coordinate curB = curA;
    if (coreB != NO_CORE) {
-      if (bandwidth[coreA][coreB] == 0 && bandwidth[coreB][coreA] == 0) {
-         dist = getHops(core[coreB].getPosition(), core[coreA].getPosition());
-         change -= dist;
+      curB = core[coreB].getPosition();
+      change += getHops(curB, newPosA) - getHops(curB, curA);
+      change -= distance.getSum(newPosB) - getHops(curA, newPosB)
+            - getHops(curB, newPosB);
+      change += distance.getSum(curB) - getHops(curA, curB);
+   }
+   /*
+    * connected cores are taken back out
+    */
+   bool connected = false;
+   int moved[2] = { coreA, coreB };
+   Coordinate newPos[2] = { newPosA, newPosB };
+   Coordinate oldPos[2] = { curA, curB };
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE) {
+         continue;
+      }
+      for (int k = netlist.neighbourBegin(moved[m]);
+            k < netlist.neighbourEnd(moved[m]); k++) {
+         int peer = netlist.getNeighbour(k);
+         if (peer == coreA || peer == coreB) {
+            connected = true;
+            continue;
+         }
+         Coordinate pos = core[peer].getPosition();
+         change += getHops(pos, newPos[m]) - getHops(pos, oldPos[m]);
       }
    }
+   /*
+    * calculate proximity cost between coreA and core B
+    */
+   if (coreB != NO_CORE && !connected) {
+      change -= getHops(newPosB, newPosA) - getHops(curB, curA);
+   }
    return change;
 }
 
@@ -259,6 +523,30 @@ void Cost::printCost() const {
          << slack << setw(12) << proximity << setw(12) << utilization;
 }
 
+void Cost::printCost(const CostDelta& change) const {
+   double newDilation = beta * (slack + change.slack) + gamma * (proximity
+         + change.proximity) + delta * (utilization + change.utilization);
+   cout << right << setiosflags(ios::fixed) << setprecision(3) << setw(12)
+         << cost + change.cost << setw(12) << compaction + change.compaction
+         << setw(12) << newDilation << setw(12) << slack + change.slack
+         << setw(12) << proximity + change.proximity << setw(12)
+         << utilization + change.utilization;
+}
+
+void Cost::printCost(const CostSnapshot& snapshot,
+      double LINK_LATENCY) const {
+   double snapshotSlack = snapshot.latencySum - snapshot.slackHops
+         * LINK_LATENCY;
+   double snapshotDilation = beta * snapshotSlack + gamma
+         * snapshot.proximitySum + delta * snapshot.utilization;
+   cout << right << setiosflags(ios::fixed) << setprecision(3) << setw(12)
+         << snapshot.cost << setw(12)
+         << (double) snapshot.compactionSum / scale << setw(12)
+         << snapshotDilation << setw(12) << snapshotSlack << setw(12)
+         << (double) snapshot.proximitySum << setw(12)
+         << snapshot.utilization;
+}
+
 string Cost::printQuiet() const {
    stringstream str;
    str << right << setiosflags(ios::fixed) << setprecision(2) << setw(12)
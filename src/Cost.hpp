@@ -8,10 +8,78 @@
 #include "Defs.hpp"
 #include "Network.hpp"
 #include "Core.hpp"
+#include "Netlist.hpp"
+#include "DistanceSum.hpp"
 
 using std::vector;
 using std::string;
 
+/*
+ * cost terms, a move is evaluated only for the terms with nonzero weight
+ */
+#define COMPACTION_TERM  1
+#define SLACK_TERM       2
+#define PROXIMITY_TERM   4
+#define UTILIZATION_TERM 8
+#define ALL_TERMS        15
+
+//connections summed together by the vectorized loop of initConnectionTerms
+#define HOP_BLOCK 8
+
+/*
+ * Change in each cost term caused by a move or a swap
+ * cost is the change in the weighted total cost
+ * the change of a term that is not evaluated is zero
+ * when a move is rejected before utilization is evaluated,
+ * bound is set and utilization and cost are lower bounds of their change
+ */
+struct CostDelta {
+   double compaction;
+   double slack;
+   double proximity;
+   double utilization;
+   double cost;
+   bool bound;
+};
+
+/*
+ * Cost terms of a placement of every core
+ * - compaction, slack hops and proximity are the integer sums kept by Cost
+ * - utilization is the utilization cost of the placement
+ */
+struct PlacementCost {
+   long long compactionSum;
+   long long slackHops;
+   long long proximitySum;
+   double utilization;
+};
+
+/*
+ * Scalar terms of the cost of a state, enough to restore the cost
+ * on a state with the same core positions
+ */
+struct CostSnapshot {
+   long long compactionSum;
+   long long slackHops;
+   double latencySum;
+   long long proximitySum;
+   double utilization;
+   double cost;
+   double initialCost;
+};
+
+/*
+ * Terms of the cost of the connections from/to a core
+ * - hops, sum of fixedBandwidth * hops
+ * - slackHops, sum of hops of the connections with a latency constraint
+ * - latency, sum of the latency constraints
+ */
+struct CoreTerms {
+   long long hops;
+   long long slackHops;
+   double latency;
+};
+
 class Cost {
    public:
       Cost();
@@ -20,12 +88,24 @@ class Cost {
       //functions
       /*
        * Initialize alpha, beta, gamma and delta
+       * moves are evaluated only for the terms with nonzero weight
        */
       void init(double alpha, double beta, double gamma, double delta);
+      /*
+       * evaluate every term of a move, even the ones with zero weight
+       * so that the cost of every term can be printed
+       */
+      void setEvaluateAll(bool enable);
       /*
        * Initialize cost of a state
        */
-      void initCost(vector< vector<double> > &bandwidth, vector< vector<double> > &latency , vector<Core> &core, const double LINK_LATENCY, Network& network);
+      void initCost(const Netlist &netlist, vector<Core> &core, const double LINK_LATENCY, Network& network);
+      /*
+       * Recalculate every term of the cost from scratch
+       * the largest difference between a tracked term and
+       * its recalculated value is returned
+       */
+      double recalculateCost(const Netlist &netlist, vector<Core> &core, const double LINK_LATENCY, Network& network);
       /*
        * Get cost
        */
@@ -34,23 +114,77 @@ class Cost {
        * print cost in a tabular format for verbose and normal printing
        */
       void printCost() const;
+      /*
+       * print cost of a state after applying "change"
+       * in the same format as printCost
+       */
+      void printCost(const CostDelta& change) const;
+      /*
+       * print cost of "snapshot" with the weights of this cost
+       * in the same format as printCost
+       */
+      void printCost(const CostSnapshot& snapshot, double LINK_LATENCY) const;
       /*
        * print cost in a detail cost in summary format
        * for verbose and normal printing
        */
       void printSummary() const;
 
+      /*
+       * save the scalar terms of the cost into "snapshot"
+       */
+      void saveSnapshot(CostSnapshot& snapshot) const;
+      /*
+       * restore the cost from "snapshot" taken at the positions of "core"
+       * distance sums are rebuilt from the core positions and utilization
+       * is taken from the network
+       */
+      void loadSnapshot(const CostSnapshot& snapshot, const vector<Core> &core, double LINK_LATENCY, const Network& network);
       /*
        * calculate cost when compation, slack and proximity are initialized
+       * utilization is taken from the utilization maintained by the network
+       */
+      void calculateCost(const Network& network);
+      /*
+       * Update compaction, slack and proximity cost when core[coreA] is moved
+       * to "newPosA" and core[coreB] (if any) to "newPosB".
+       * This must be called before the cores are moved
+       */
+      void updateCost(const Netlist &netlist, double LINK_LATENCY, const vector<Core> &core, int coreA,
+            Coordinate newPosA, int coreB, Coordinate newPosB);
+      /*
+       * Evaluate change in cost when core[coreA] is moved to an empty position
+       * "newPos" or when core[coreA] and core[coreB] are swapped.
+       * Neither the cores nor the network are modified
+       * Terms are evaluated from the cheapest one, the evaluation stops
+       * before utilization when the change in cost cannot be below "threshold"
+       * When every term is evaluated, "placement" (if not NULL) is set to
+       * the cost terms of the placement after the move
+       */
+      CostDelta evaluateMove(const Netlist &netlist, double LINK_LATENCY, const vector<Core> &core, const Network& network, int coreA, Coordinate newPos,
+            double threshold, PlacementCost* placement) const;
+      CostDelta evaluateSwap(const Netlist &netlist, double LINK_LATENCY, const vector<Core> &core, const Network& network, int coreA, int coreB,
+            double threshold, PlacementCost* placement) const;
+      /*
+       * Change in cost to a placement whose cost terms are known
+       * the result is the same as evaluating the move to the placement
        */
-      void calculateCost(vector< vector<double> > &bandwidth, vector<Core> &core, Network& network);
+      CostDelta evaluatePlacement(const PlacementCost& placement, double LINK_LATENCY) const;
       /*
-       * Add/remove compaction, slack and proximity cost when a core is moved.
-       * index specifies indexing number to access moved core in core vector
-       * op specifies operation ADD or REMOVE
+       * check whether moves are evaluated with utilization cost
        */
-      void updateCost(vector< vector<double> > &bandwidth, vector< vector<double> > &latency, double LINK_LATENCY,
-            vector<Core> &core, int op, int coreA, int coreB = NO_CORE);
+      bool isUtilizationEvaluated() const;
+      /*
+       * Terms of the connections from/to core[index]
+       * every connection counts for both of its cores
+       */
+      CoreTerms getCoreTerms(const Netlist &netlist, const vector<Core> &core, int index) const;
+      /*
+       * Cost of the connections of a core with "terms"
+       * alpha * compaction + (1 - alpha) * beta * slack of the connections
+       * the costs of every core add up to twice these terms of the whole cost
+       */
+      double getCoreCost(const CoreTerms& terms, double LINK_LATENCY) const;
       /*
        * Return a string which consists of cost value
        * This function returns a string instead of printing because
@@ -61,36 +195,123 @@ class Cost {
       double getCostRatio();
 
    private:
+      /*
+       * exact change in the integer sums of compaction, slack and proximity
+       */
+      struct TermChange {
+         long long compaction;
+         long long slackHops;
+         long long proximity;
+      };
+
+      typedef CostDelta (Cost::*EvaluateFunction)(const Netlist &netlist,
+            double LINK_LATENCY, const vector<Core> &core,
+            const Network& network, int coreA, Coordinate newPosA, int coreB,
+            Coordinate newPosB, double threshold,
+            PlacementCost* placement) const;
+
       //variable
       double alpha, beta, gamma, delta;
+      /*
+       * terms with nonzero weight, terms evaluated for a move
+       * and the instance of evaluate that is specialized for them
+       */
+      int terms;
+      int evaluatedTerms;
+      EvaluateFunction evaluateFunction;
       double cost, initialCost;
       double compaction, dilation, slack, proximity, utilization;
+      /*
+       * compaction, slack and proximity are accumulated as integers
+       * so that repeated updates do not drift
+       * - compactionSum is compaction in units of 1 / scale, the scale of
+       *   the fixed point bandwidth of the netlist
+       * - slack is latencySum - slackHops * LINK_LATENCY, slackHops is
+       *   the number of hops of the connections with a latency constraint
+       */
+      long long scale;
+      long long compactionSum;
+      long long slackHops;
+      double latencySum;
+      long long proximitySum;
+      /*
+       * distance sums of core positions used for proximity cost
+       */
+      DistanceSum distance;
+      /*
+       * scratch of initConnectionTerms, one entry for every connection
+       * kept so that recalculating the cost does not allocate
+       */
+      vector<int> connectionDx;
+      vector<int> connectionDy;
+      vector<long long> connectionBandwidth;
+      vector<long long> connectionConstrained;
 
       //function
       /*
-       * initialize compaction, dilation, slack and proximity cost
+       * calculate every term and the cost from scratch
+       */
+      void initTerms(const Netlist &netlist, vector<Core> &core, const double LINK_LATENCY, Network& network);
+      /*
+       * initialize compaction and slack cost in a single pass
+       * over every connection
+       */
+      void initConnectionTerms(const Netlist &netlist, const vector<Core> &core);
+      /*
+       * initialize dilation, proximity and utilization cost
+       * slack must be initialized before
+       */
+      double initDilation(const Netlist &netlist, vector<Core> &core, const double LINK_LATENCY, Network& network);
+      long long initProximity(const Netlist &netlist, vector<Core> &core);
+      /*
+       * set compaction, slack and proximity from their integer sums
        */
-      double initCompaction(vector< vector<double> > &bandwidth, vector<Core> &core);
-      double initDilation(vector< vector<double> > &bandwidth, vector< vector<double> > &latency, vector<Core> &core, const double LINK_LATENCY, Network& network);
-      double initSlack(vector< vector<double> > &latency, vector<Core> &core, const double LINK_LATENCY);
-      double initProximity(vector< vector<double> > &bandwidth, vector<Core> &core);
+      void setTerms(const double LINK_LATENCY);
 
       /*
        * Update and calculate utilization cost
        */
-      double utilizationCost(vector< vector<double> > &bandwidth, vector<Core> &core, Network& network);
+      double utilizationCost(const Netlist &netlist, vector<Core> &core, Network& network);
 
 
       /*
-       * calculate change in compation, slack and proximity cost
-       * the change is calculate when core[coreA] is moved
-       * or core[coreA] is swapped with core[coreB]
-       * coreA, coreB specify indexing number to access moved core in core vector
-       * the change in cost is calculated using connection from/to core[coreA] and core[coreB]
+       * calculate change in compaction and slack (TERMS) or proximity cost
+       * when core[coreA] is placed at "newPosA" and core[coreB] (if any)
+       * at "newPosB", core[coreA] and core[coreB] are swapped when
+       * newPosA is the position of core[coreB]
+       * the old and new positions are taken in the same pass over the
+       * adjacency lists of the moved cores, the connection between them
+       * is counted once with both of its ends moved
+       * the changes are in the units of the integer sums
+       */
+      template<int TERMS>
+      void changeConnections(const Netlist &netlist, const vector<Core> &core, int coreA,
+            Coordinate newPosA, int coreB, Coordinate newPosB, TermChange &change) const;
+      long long changeProximity(const Netlist &netlist, const vector<Core> &core, int coreA,
+            Coordinate newPosA, int coreB, Coordinate newPosB) const;
+      /*
+       * evaluate change in compaction, slack and proximity cost
+       * when core[coreA] is placed at "newPosA" and core[coreB] (if any)
+       * is placed at "newPosB"
+       * only the terms in TERMS are evaluated
+       */
+      template<int TERMS>
+      void evaluateTerms(const Netlist &netlist, const vector<Core> &core, int coreA,
+            Coordinate newPosA, int coreB, Coordinate newPosB, TermChange &change) const;
+      /*
+       * evaluate change in cost when core[coreA] is placed at "newPosA"
+       * and core[coreB] (if any) is placed at "newPosB"
+       * only the terms in TERMS are evaluated
+       * utilization is not evaluated when the change cannot be below "threshold"
+       * "placement" is set when every term in TERMS is evaluated
+       */
+      template<int TERMS>
+      CostDelta evaluate(const Netlist &netlist, double LINK_LATENCY, const vector<Core> &core, const Network& network, int coreA, Coordinate newPosA,
+            int coreB, Coordinate newPosB, double threshold, PlacementCost* placement) const;
+      /*
+       * select the instance of evaluate for "terms"
        */
-      double changeCompaction(vector< vector<double> > &bandwidth, vector<Core> &core, int coreA, int coreB);
-      double changeSlack(vector< vector<double> > &latency, const double LINK_LATENCY, vector<Core> &core, int coreA, int coreB);
-      double changeProximity(vector< vector<double> > &bandwidth, vector<Core> &core, int coreA, int coreB);
+      static EvaluateFunction getEvaluateFunction(int terms);
 };
 
 #endif
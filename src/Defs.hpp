@@ -4,6 +4,8 @@
 #define NO_ERR             0
 #define FILE_OPEN_ERR      1
 #define ILLEGAL_STATE_ERR  2
+#define INPUT_ERR          3
+#define CONNECTION_ERR     4
 
 //Default value
 #define ALPHA  1
@@ -17,6 +19,18 @@
 #define REJECT 200 
 #define ACCEPT 100 
 
+//bandwidth is accumulated in units of 1 / scale of the netlist, the scale is
+//the smallest power of ten from FIXED_POINT_SCALE to MAX_FIXED_POINT_SCALE
+//that represents every bandwidth exactly
+#define FIXED_POINT_SCALE 1000
+#define MAX_FIXED_POINT_SCALE 1000000
+
+//acceptance rate that the range limit of moves is adjusted towards
+#define TARGET_ACCEPT_RATE 0.44
+
+//part of the moves whose core is selected by its cost
+#define HOT_CORE_RATE 0.75
+
 //operation for update cost
 #define REMOVE	0
 #define ADD	1
@@ -48,4 +62,20 @@ enum Direction {
    RIGHT
 };
 
+/*
+ * Kinds of moves proposed with a range limit
+ * - RANGE_MOVE moves a core to any position within the range limit
+ *   around it, swapping it with the core there (if any)
+ * - SHIFT_MOVE moves a core to an empty neighbouring position
+ * - NEIGHBOUR_SWAP swaps a core with a core on a neighbouring position
+ * a move to a latency-feasible position has none of them, NO_MOVE_TYPE
+ */
+enum MoveType {
+   RANGE_MOVE,
+   SHIFT_MOVE,
+   NEIGHBOUR_SWAP,
+   NUM_MOVE_TYPES
+};
+#define NO_MOVE_TYPE -1
+
 #endif
@@ -0,0 +1,75 @@
+#include <cassert>
+
+#include "DistanceSum.hpp"
+
+using namespace std;
+
+DistanceSum::DistanceSum() {
+   count = 0;
+   totalX = 0;
+   totalY = 0;
+}
+
+DistanceSum::~DistanceSum() {
+}
+
+void DistanceSum::init(int row, int col) {
+   xCount = vector<long long> (col + 1);
+   xSum = vector<long long> (col + 1);
+   yCount = vector<long long> (row + 1);
+   ySum = vector<long long> (row + 1);
+   count = 0;
+   totalX = 0;
+   totalY = 0;
+}
+
+void DistanceSum::add(Coordinate pos) {
+   change(xCount, pos.x, 1);
+   change(xSum, pos.x, pos.x);
+   change(yCount, pos.y, 1);
+   change(ySum, pos.y, pos.y);
+   count++;
+   totalX += pos.x;
+   totalY += pos.y;
+}
+
+void DistanceSum::remove(Coordinate pos) {
+   change(xCount, pos.x, -1);
+   change(xSum, pos.x, -pos.x);
+   change(yCount, pos.y, -1);
+   change(ySum, pos.y, -pos.y);
+   count--;
+   totalX -= pos.x;
+   totalY -= pos.y;
+}
+
+long long DistanceSum::getSum(Coordinate pos) const {
+   return axisSum(xCount, xSum, totalX, pos.x)
+         + axisSum(yCount, ySum, totalY, pos.y);
+}
+
+long long DistanceSum::axisSum(const vector<long long> &treeCount,
+      const vector<long long> &treeSum, long long total, int c) const {
+   /*
+    * coordinates <= c are c - coordinate away
+    * coordinates > c are coordinate - c away
+    */
+   long long countLE = prefix(treeCount, c);
+   long long sumLE = prefix(treeSum, c);
+   return (c * countLE - sumLE) + ((total - sumLE) - c * (count - countLE));
+}
+
+void DistanceSum::change(vector<long long> &tree, int c, long long value) {
+   assert(c >= 0 && c + 1 < (int) tree.size());
+   for (int i = c + 1; i < (int) tree.size(); i += i & (-i)) {
+      tree[i] += value;
+   }
+}
+
+long long DistanceSum::prefix(const vector<long long> &tree, int c) {
+   long long sum = 0;
+   for (int i = c + 1; i > 0; i -= i & (-i)) {
+      sum += tree[i];
+   }
+   return sum;
+}
@@ -0,0 +1,62 @@
+#ifndef DISTANCESUM_HPP
+#define DISTANCESUM_HPP
+
+#include <vector>
+
+#include "Defs.hpp"
+
+using std::vector;
+
+/*
+ * Sum of Manhattan distances from a position to a set of positions
+ * The x and y coordinates of the positions are counted and summed in
+ * Fenwick trees so that adding, removing and summing take O(log mesh).
+ */
+class DistanceSum {
+   public:
+      DistanceSum();
+      ~DistanceSum();
+
+      /*
+       * initialize an empty set on a mesh of size row x col
+       */
+      void init(int row, int col);
+      /*
+       * add/remove position "pos" to/from the set
+       */
+      void add(Coordinate pos);
+      void remove(Coordinate pos);
+      /*
+       * get sum of hops from "pos" to every position in the set
+       */
+      long long getSum(Coordinate pos) const;
+
+   private:
+      /*
+       * Fenwick trees of count and sum of x and y coordinates
+       * tree index is coordinate + 1
+       */
+      vector<long long> xCount;
+      vector<long long> xSum;
+      vector<long long> yCount;
+      vector<long long> ySum;
+      long long count;
+      long long totalX;
+      long long totalY;
+
+      /*
+       * add "value" at coordinate "c" of a tree
+       */
+      static void change(vector<long long> &tree, int c, long long value);
+      /*
+       * sum of a tree over coordinates [0, c]
+       */
+      static long long prefix(const vector<long long> &tree, int c);
+      /*
+       * sum of distances in one dimension from coordinate "c"
+       */
+      long long axisSum(const vector<long long> &treeCount,
+            const vector<long long> &treeSum, long long total, int c) const;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <iomanip>
+
+#include "MoveSelector.hpp"
+
+using namespace std;
+
+static const char* moveTypeName[NUM_MOVE_TYPES] = { "Range", "Shift", "Swap" };
+
+MoveSelector::MoveSelector() {
+   init();
+}
+
+MoveSelector::~MoveSelector() {
+}
+
+void MoveSelector::init() {
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      gain[k] = 0;
+      work[k] = 0;
+      probability[k] = 1.0 / NUM_MOVE_TYPES;
+      proposed[k] = 0;
+      accepted[k] = 0;
+      totalGain[k] = 0;
+      totalWork[k] = 0;
+   }
+}
+
+int MoveSelector::select(RandomGenerator& random) const {
+   double r = random.uniform_0_1();
+   for (int k = 0; k < NUM_MOVE_TYPES - 1; k++) {
+      if (r < probability[k]) {
+         return k;
+      }
+      r -= probability[k];
+   }
+   return NUM_MOVE_TYPES - 1;
+}
+
+void MoveSelector::update(int type, double gain, long long work) {
+   proposed[type]++;
+   totalWork[type] += work;
+   this->work[type] += work;
+   if (gain > 0) {
+      accepted[type]++;
+      totalGain[type] += gain;
+      this->gain[type] += gain;
+   }
+   reweight();
+}
+
+void MoveSelector::decay() {
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      gain[k] *= SELECTOR_DECAY;
+      work[k] *= SELECTOR_DECAY;
+   }
+   reweight();
+}
+
+void MoveSelector::reweight() {
+   double rate[NUM_MOVE_TYPES];
+   double sum = 0;
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      /*
+       * a move type that has not been tried yet is selected
+       * with equal probability until every type has some work
+       */
+      if (work[k] <= 0) {
+         for (int j = 0; j < NUM_MOVE_TYPES; j++) {
+            probability[j] = 1.0 / NUM_MOVE_TYPES;
+         }
+         return;
+      }
+      rate[k] = gain[k] / work[k];
+      sum += rate[k];
+   }
+   //without any gain every move type is equally likely
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      probability[k] = (sum > 0) ? SELECTOR_MIN_PROBABILITY + (1
+            - NUM_MOVE_TYPES * SELECTOR_MIN_PROBABILITY) * rate[k] / sum
+            : 1.0 / NUM_MOVE_TYPES;
+   }
+}
+
+void MoveSelector::printSummary() const {
+   long long total = 0;
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      total += proposed[k];
+   }
+   if (total == 0) {
+      return;
+   }
+   cout << "# Move type statistics" << endl;
+   cout << "# " << setw(8) << "Type" << setw(12) << "Proposed" << setw(12)
+         << "Improved" << setw(14) << "Gain" << setw(12) << "Work"
+         << setw(14) << "Gain / work" << setw(12) << "Final prob" << endl;
+   for (int k = 0; k < NUM_MOVE_TYPES; k++) {
+      cout << "# " << setw(8) << moveTypeName[k] << setw(12) << proposed[k]
+            << setw(12) << accepted[k] << setiosflags(ios::fixed)
+            << setprecision(3) << setw(14) << totalGain[k] << setw(12)
+            << totalWork[k] << setw(14) << ((totalWork[k] > 0) ? totalGain[k]
+            / totalWork[k] : 0) << setw(12) << probability[k] << endl;
+   }
+}
@@ -0,0 +1,78 @@
+#ifndef MOVESELECTOR_HPP
+#define MOVESELECTOR_HPP
+
+#include <vector>
+
+#include "Defs.hpp"
+#include "RandomGenerator.hpp"
+
+//every move type is selected at least with this probability
+#define SELECTOR_MIN_PROBABILITY 0.05
+//part of the gain and work of a move type kept at a temperature change
+#define SELECTOR_DECAY 0.5
+
+using std::vector;
+
+/*
+ * Online selection of move types (a multi-armed bandit)
+ * Every move type earns the decrease in cost of its accepted moves and
+ * spends the work taken to evaluate and apply its moves, counted in
+ * adjacency entries and route steps so that runs repeat from a seed.
+ * A move type is selected with probability proportional to its gain per
+ * unit of work, with a floor of SELECTOR_MIN_PROBABILITY so that no type
+ * stops being tried. Gain and work fade by SELECTOR_DECAY at every
+ * temperature, so the selection follows the move types that pay off as
+ * the temperature falls.
+ */
+class MoveSelector {
+   public:
+      MoveSelector();
+      ~MoveSelector();
+
+      /*
+       * start with every move type equally likely and no statistics
+       */
+      void init();
+      /*
+       * randomly select a move type
+       */
+      int select(RandomGenerator& random) const;
+      /*
+       * record a move of "type" that decreased the cost by "gain"
+       * (0 when the move was rejected or increased the cost)
+       * and took "work"
+       */
+      void update(int type, double gain, long long work);
+      /*
+       * fade the gain and work of every move type
+       * called when the temperature changes
+       */
+      void decay();
+      /*
+       * print statistics of every move type
+       * nothing is printed before the first move
+       */
+      void printSummary() const;
+
+   private:
+      /*
+       * gain and work, faded at every temperature
+       */
+      double gain[NUM_MOVE_TYPES];
+      double work[NUM_MOVE_TYPES];
+      double probability[NUM_MOVE_TYPES];
+      /*
+       * statistics of the whole run
+       */
+      long long proposed[NUM_MOVE_TYPES];
+      long long accepted[NUM_MOVE_TYPES];
+      double totalGain[NUM_MOVE_TYPES];
+      long long totalWork[NUM_MOVE_TYPES];
+
+      /*
+       * set selection probabilities from gain per unit of work
+       */
+      void reweight();
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cstddef>
+#include <climits>
+#include <cmath>
+
+#include "Netlist.hpp"
+
+using namespace std;
+
+bool Netlist::Entry::operator<(const Entry& other) const {
+   if (from != other.from) {
+      return from < other.from;
+   }
+   return to < other.to;
+}
+
+Netlist::Netlist() {
+   numCore = 0;
+   scale = FIXED_POINT_SCALE;
+   outStart = vector<int> (1, 0);
+   inStart = vector<int> (1, 0);
+   neighbourStart = vector<int> (1, 0);
+}
+
+Netlist::~Netlist() {
+}
+
+void Netlist::init(int numCore) {
+   this->numCore = numCore;
+   entries.clear();
+   build(0);
+}
+
+void Netlist::addConnection(int from, int to, double bandwidth,
+      double latency) {
+   Entry e;
+   e.from = from;
+   e.to = to;
+   e.bandwidth = bandwidth;
+   e.latency = latency;
+   entries.push_back(e);
+}
+
+void Netlist::build(double LINK_LATENCY, long long scale) {
+   unsigned int i, j;
+   Connection c;
+   this->scale = scale;
+
+   /*
+    * sort connections by (from, to)
+    * the stable sort keeps the connection added last at the end of
+    * a run of duplicates, it replaces the ones added before
+    */
+   stable_sort(entries.begin(), entries.end());
+   vector<Entry> unique;
+   for (i = 0; i < entries.size(); i++) {
+      if (i + 1 < entries.size() && !(entries[i] < entries[i + 1])) {
+         continue;
+      }
+      //no bandwidth and no latency means no connection
+      if (entries[i].bandwidth != 0 || entries[i].latency != 0) {
+         unique.push_back(entries[i]);
+      }
+   }
+   entries.swap(unique);
+
+   /*
+    * out list, entries are already sorted by (from, to)
+    */
+   outStart = vector<int> (numCore + 1, 0);
+   outList.clear();
+   for (i = 0; i < entries.size(); i++) {
+      c.peer = entries[i].to;
+      c.bandwidth = entries[i].bandwidth;
+      c.latency = entries[i].latency;
+      c.maxHops = getMaxHops(c.latency, LINK_LATENCY);
+      c.fixedBandwidth = llround(c.bandwidth * scale);
+      outList.push_back(c);
+      outStart[entries[i].from + 1]++;
+   }
+   for (int k = 0; k < numCore; k++) {
+      outStart[k + 1] += outStart[k];
+   }
+
+   /*
+    * in list, counting sort by "to" keeps every list sorted by "from"
+    */
+   inStart = vector<int> (numCore + 1, 0);
+   inList = vector<Connection> (entries.size());
+   for (i = 0; i < entries.size(); i++) {
+      inStart[entries[i].to + 1]++;
+   }
+   for (int k = 0; k < numCore; k++) {
+      inStart[k + 1] += inStart[k];
+   }
+   vector<int> next(inStart.begin(), inStart.end() - 1);
+   for (i = 0; i < entries.size(); i++) {
+      c.peer = entries[i].from;
+      c.bandwidth = entries[i].bandwidth;
+      c.latency = entries[i].latency;
+      c.maxHops = getMaxHops(c.latency, LINK_LATENCY);
+      c.fixedBandwidth = llround(c.bandwidth * scale);
+      inList[next[entries[i].to]++] = c;
+   }
+
+   /*
+    * neighbour list, merge of the out and in lists
+    * only connections with bandwidth are neighbours
+    */
+   neighbourStart = vector<int> (numCore + 1, 0);
+   neighbourList.clear();
+   for (int k = 0; k < numCore; k++) {
+      i = outStart[k];
+      j = inStart[k];
+      while ((int) i < outStart[k + 1] || (int) j < inStart[k + 1]) {
+         int peer;
+         if ((int) j >= inStart[k + 1] || ((int) i < outStart[k + 1]
+               && outList[i].peer <= inList[j].peer)) {
+            if (outList[i].bandwidth == 0) {
+               i++;
+               continue;
+            }
+            peer = outList[i++].peer;
+         } else {
+            if (inList[j].bandwidth == 0) {
+               j++;
+               continue;
+            }
+            peer = inList[j++].peer;
+         }
+         if (peer != k && (neighbourList.size() == (unsigned int)
+               neighbourStart[k] || neighbourList.back() != peer)) {
+            neighbourList.push_back(peer);
+         }
+      }
+      neighbourStart[k + 1] = neighbourList.size();
+   }
+}
+
+int Netlist::getMaxHops(double latency, double LINK_LATENCY) {
+   //no latency constraint
+   if (latency == 0) {
+      return INT_MAX;
+   }
+   //even a connection without a hop is too slow
+   if (latency < 0) {
+      return -1;
+   }
+   if (LINK_LATENCY <= 0) {
+      return INT_MAX;
+   }
+   /*
+    * the constraint is latency >= hops * LINK_LATENCY
+    * the estimate is corrected so that rounding of the division
+    * gives the same result as the constraint
+    */
+   double estimate = floor(latency / LINK_LATENCY);
+   if (estimate >= INT_MAX - 1) {
+      return INT_MAX;
+   }
+   int hops = (int) estimate;
+   while ((hops + 1) * LINK_LATENCY <= latency) {
+      hops++;
+   }
+   while (hops >= 0 && hops * LINK_LATENCY > latency) {
+      hops--;
+   }
+   return hops;
+}
+
+const Connection* Netlist::find(int from, int to) const {
+   for (int k = outStart[from]; k < outStart[from + 1]; k++) {
+      if (outList[k].peer == to) {
+         return &outList[k];
+      }
+   }
+   return NULL;
+}
+
+double Netlist::getBandwidth(int from, int to) const {
+   const Connection* c = find(from, to);
+   return (c != NULL) ? c->bandwidth : 0;
+}
+
+double Netlist::getLatency(int from, int to) const {
+   const Connection* c = find(from, to);
+   return (c != NULL) ? c->latency : 0;
+}
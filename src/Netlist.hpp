@@ -0,0 +1,170 @@
+#ifndef NETLIST_HPP
+#define NETLIST_HPP
+
+#include <vector>
+
+#include "Defs.hpp"
+
+using std::vector;
+
+/*
+ * Connection record in an adjacency list
+ * - peer is the core at the other end of the connection
+ * - bandwidth = 0 means the connection has only a latency constraint
+ * - latency = 0 means the connection has no latency constraint
+ * - maxHops is the largest number of hops that meets the latency constraint
+ * - fixedBandwidth is bandwidth * scale of the netlist rounded to an integer
+ */
+struct Connection {
+   int peer;
+   double bandwidth;
+   double latency;
+   int maxHops;
+   long long fixedBandwidth;
+};
+
+/*
+ * Communication graph between cores in compressed sparse row format
+ * - out list of core i holds connections from core i, peer is the destination
+ * - in list of core i holds connections to core i, peer is the source
+ * - neighbour list of core i holds every core connected to core i
+ *   by bandwidth in either direction, each core is listed once
+ * Connections of core i are stored in [outBegin(i), outEnd(i)) of the
+ * out list and [inBegin(i), inEnd(i)) of the in list, sorted by peer.
+ */
+class Netlist {
+   public:
+      Netlist();
+      ~Netlist();
+
+      /*
+       * clear the netlist and set the number of cores
+       */
+      void init(int numCore);
+      /*
+       * add a connection from core "from" to core "to"
+       * a connection added again replaces the previous one
+       * build must be called after all connections are added
+       */
+      void addConnection(int from, int to, double bandwidth, double latency);
+      /*
+       * build the adjacency lists from the added connections
+       * LINK_LATENCY is latency of a hop used to set the hop limits
+       * bandwidth is kept in fixed point in units of 1 / "scale"
+       */
+      void build(double LINK_LATENCY, long long scale = FIXED_POINT_SCALE);
+
+      /*
+       * get number of cores
+       */
+      int size() const;
+      /*
+       * get scale of the fixed point bandwidth
+       */
+      long long getScale() const;
+      /*
+       * get number of connections
+       */
+      int getNumConnection() const;
+      /*
+       * range of connections from/to core[index]
+       */
+      int outBegin(int index) const;
+      int outEnd(int index) const;
+      int inBegin(int index) const;
+      int inEnd(int index) const;
+      int neighbourBegin(int index) const;
+      int neighbourEnd(int index) const;
+      /*
+       * get connection or neighbour at position k of a list
+       */
+      const Connection& getOut(int k) const;
+      const Connection& getIn(int k) const;
+      int getNeighbour(int k) const;
+      /*
+       * get bandwidth and latency of a connection from "from" to "to"
+       * zero is returned when there is no such connection
+       */
+      double getBandwidth(int from, int to) const;
+      double getLatency(int from, int to) const;
+
+   private:
+      struct Entry {
+         int from;
+         int to;
+         double bandwidth;
+         double latency;
+         bool operator<(const Entry& other) const;
+      };
+
+      int numCore;
+      long long scale;
+      vector<Entry> entries;
+
+      vector<int> outStart;
+      vector<Connection> outList;
+      vector<int> inStart;
+      vector<Connection> inList;
+      vector<int> neighbourStart;
+      vector<int> neighbourList;
+
+      /*
+       * largest number of hops within "latency"
+       */
+      static int getMaxHops(double latency, double LINK_LATENCY);
+      /*
+       * find a connection from "from" to "to" in the out list
+       * NULL is returned when there is no such connection
+       */
+      const Connection* find(int from, int to) const;
+};
+
+inline int Netlist::size() const {
+   return numCore;
+}
+
+inline long long Netlist::getScale() const {
+   return scale;
+}
+
+inline int Netlist::getNumConnection() const {
+   return outList.size();
+}
+
+inline int Netlist::outBegin(int index) const {
+   return outStart[index];
+}
+
+inline int Netlist::outEnd(int index) const {
+   return outStart[index + 1];
+}
+
+inline int Netlist::inBegin(int index) const {
+   return inStart[index];
+}
+
+inline int Netlist::inEnd(int index) const {
+   return inStart[index + 1];
+}
+
+inline int Netlist::neighbourBegin(int index) const {
+   return neighbourStart[index];
+}
+
+inline int Netlist::neighbourEnd(int index) const {
+   return neighbourStart[index + 1];
+}
+
+inline const Connection& Netlist::getOut(int k) const {
+   return outList[k];
+}
+
+inline const Connection& Netlist::getIn(int k) const {
+   return inList[k];
+}
+
+inline int Netlist::getNeighbour(int k) const {
+   return neighbourList[k];
+}
+
+#endif
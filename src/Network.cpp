@@ -3,211 +3,466 @@
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <algorithm>
 
 #include "Network.hpp"
 
 using namespace std;
 
+TrialMove::TrialMove() {
+   valid = false;
+   coreA = NO_CORE;
+   coreB = NO_CORE;
+   boundStamp = 0;
+   util = 0;
+}
+
+TrialMove::TrialMove(const TrialMove& other) {
+   valid = false;
+   coreA = NO_CORE;
+   coreB = NO_CORE;
+   boundStamp = 0;
+   util = 0;
+}
+
+TrialMove& TrialMove::operator=(const TrialMove& other) {
+   //keep own scratch, only the trial move is invalidated
+   valid = false;
+   return *this;
+}
+
 Network::Network() {
    row = 0;
    col = 0;
+   routeSteps = 0;
 }
 
 Network::~Network() {
 }
 
-void Network::init(int r, int c) {
+void Network::init(int r, int c, long long scale) {
    row = r;
    col = c;
-   routers = vector< vector<Router> > (row, vector<Router> (col));
-   utilization.init(r, c);
+   routers = vector<Router> (row * col);
+   utilization.init(r, c, scale);
+   occupied.init(row * col);
+   //routes are shared with copies of the network
+   routeTable = shared_ptr<RouteTable> (new RouteTable());
+   routeTable->init(r, c);
+   //trial move changes are allocated on first evaluation
+   trial.valid = false;
+   trial.turns.clear();
+}
+
+int Network::getRow() const {
+   return row;
+}
+
+int Network::getCol() const {
+   return col;
+}
+
+void Network::initTrial() const {
+   trial.routerList.clear();
+   trial.turns = vector<int> (row * col * MAX_TURNS);
+   trial.connection = vector<int> (row * col * MAX_DIRECTION);
+   trial.bandwidth = vector<long long> (row * col * MAX_DIRECTION);
+   trial.psudonode = vector<char> (row * col);
+   trial.routerMark = vector<char> (row * col);
+   trial.boundMark = vector<int> (row * col);
+   trial.boundStamp = 0;
 }
 
 void Network::addCore(Coordinate pos, int coreIndex) {
    assert(pos.y < row);
    assert(pos.x < col);
-   routers[pos.y][pos.x].setCore(coreIndex);
+   routers[pos.y * col + pos.x].setCore(coreIndex);
+   occupied.set(pos.y * col + pos.x, coreIndex != NO_CORE);
 }
 
 void Network::removeCore(Coordinate pos) {
    assert(pos.y < row);
    assert(pos.x < col);
-   routers[pos.y][pos.x].setCore(NO_CORE);
+   routers[pos.y * col + pos.x].setCore(NO_CORE);
+   occupied.set(pos.y * col + pos.x, false);
 }
 
 int Network::getCoreIndex(Coordinate pos) {
    assert(pos.y < row);
    assert(pos.x < col);
-   return routers[pos.y][pos.x].getCoreIndex();
+   return routers[pos.y * col + pos.x].getCoreIndex();
 }
 
 bool Network::hasCore(Coordinate pos) {
    assert(pos.y < row);
    assert(pos.x < col);
-   return routers[pos.y][pos.x].getCoreIndex() != NO_CORE;
+   return routers[pos.y * col + pos.x].getCoreIndex() != NO_CORE;
+}
+
+const Bitboard& Network::getOccupancy() const {
+   return occupied;
 }
 
 void Network::changeConnection(Coordinate from, Coordinate to, int op) {
+   int length;
+   const RouteStep* r = getRoute(from, to, length);
+   for (int i = 0; i < length; i++) {
+      routers[RouteTable::getNode(r[i])].changeTurn(RouteTable::getTurn(r[i]),
+            op);
+   }
+}
+
+const RouteStep* Network::getRoute(Coordinate from, Coordinate to,
+      int& length) const {
    assert(from.y < row);
    assert(from.x < col);
    assert(to.y < row);
    assert(to.x < col);
 
-   Coordinate path;
-   path.x = from.x;
-   path.y = from.y;
+   const RouteStep* r = routeTable->getRoute(from.y * col + from.x,
+         to.y * col + to.x, length);
+   routeSteps += length;
+   return r;
+}
+
+void Network::updateUtilization(const Netlist &netlist,
+      const vector<Core> &core) {
+   const RouteStep* r;
+   int length;
+   utilization.reset();
+   trial.valid = false;
+
+   for (unsigned int start = 0; start < core.size(); start++) {
+      for (int k = netlist.outBegin(start); k < netlist.outEnd(start); k++) {
+         const Connection& c = netlist.getOut(k);
+         /*
+          * has a connection
+          * add the connection to every link it leaves
+          */
+         if (c.bandwidth != 0) {
+            r = getRoute(core[start].getPosition(),
+                  core[c.peer].getPosition(), length);
+            for (int i = 0; i < length; i++) {
+               utilization.changeLink(RouteTable::getNode(r[i]),
+                     Router::getOutput(RouteTable::getTurn(r[i])), 1,
+                     c.fixedBandwidth);
+            }
+         }
+      }
+   }
    /*
-    * Move in x direction
+    * only links starting from psudonodes are counted
     */
-   while (path.x != to.x) {
-      if (path.x < to.x) { //go right
-         routers[path.y][path.x].changeTurn(LEFT_RIGHT, op);
-         path.x++;
-      } else { //go left
-         routers[path.y][path.x].changeTurn(RIGHT_LEFT, op);
-         path.x--;
+   for (int r = 0; r < row; r++) {
+      for (int c = 0; c < col; c++) {
+         utilization.setPsudonode(r * col + c,
+               routers[r * col + c].isPsudonode());
       }
    }
+   utilization.calculateUtil();
+}
+
+double Network::calculateUtilization() {
+   return utilization.calculateUtil();
+}
+
+double Network::getUtilization() const {
+   return utilization.getUtil();
+}
+
+double Network::evaluateUtilization(const Netlist &netlist,
+      const vector<Core> &core, int coreA, Coordinate newPosA, int coreB,
+      Coordinate newPosB) const {
+   unsigned int i;
+   int nodeId, t, length;
+   const RouteStep* r;
+   TrialEdge edge;
+
+   /*
+    * the changes are allocated on first use
+    */
+   if (trial.turns.empty()) {
+      initTrial();
+   }
 
    /*
-    * Turn
+    * clear changes of the previous trial move
     */
-   if (from.x < to.x) { //from left
-      if (from.y < to.y) { //go up
-         routers[path.y][path.x].changeTurn(LEFT_TOP, op);
-         path.y++;
-      } else if (from.y > to.y) { //go down
-         routers[path.y][path.x].changeTurn(LEFT_BOTTOM, op);
-         path.y--;
+   for (i = 0; i < trial.routerList.size(); i++) {
+      nodeId = trial.routerList[i];
+      trial.routerMark[nodeId] = false;
+      for (t = 0; t < MAX_TURNS; t++) {
+         trial.turns[nodeId * MAX_TURNS + t] = 0;
       }
-   } else if (from.x > to.x) { //from right
-      if (from.y < to.y) { //go up
-         routers[path.y][path.x].changeTurn(RIGHT_TOP, op);
-         path.y++;
-      } else if (from.y > to.y) { //go down
-         routers[path.y][path.x].changeTurn(RIGHT_BOTTOM, op);
-         path.y--;
+      for (t = 0; t < MAX_DIRECTION; t++) {
+         trial.connection[nodeId * MAX_DIRECTION + t] = 0;
+         trial.bandwidth[nodeId * MAX_DIRECTION + t] = 0;
       }
    }
+   trial.routerList.clear();
+   trial.edges.clear();
+
+   trial.coreA = coreA;
+   trial.coreB = coreB;
+   trial.posA = newPosA;
+   trial.posB = newPosB;
+   trial.oldPosA = core[coreA].getPosition();
+   trial.oldPosB = (coreB != NO_CORE) ? core[coreB].getPosition() : newPosB;
 
    /*
-    * Move in y direction
+    * routers where the moved cores are removed and placed
     */
-   while (path.y != to.y) {
-      if (path.y < to.y) { //go up
-         routers[path.y][path.x].changeTurn(BOTTOM_TOP, op);
-         path.y++;
-      } else { //go down 
-         routers[path.y][path.x].changeTurn(TOP_BOTTOM, op);
-         path.y--;
+   markTrialRouter(trial.oldPosA.y * col + trial.oldPosA.x);
+   markTrialRouter(newPosA.y * col + newPosA.x);
+   if (coreB != NO_CORE) {
+      markTrialRouter(trial.oldPosB.y * col + trial.oldPosB.x);
+      markTrialRouter(newPosB.y * col + newPosB.x);
+   }
+
+   /*
+    * list connections from/to the moved cores,
+    * a connection between the moved cores is listed once
+    */
+   int moved[2] = { coreA, coreB };
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE || (m == 1 && coreB == coreA)) {
+         continue;
+      }
+      for (int k = netlist.outBegin(moved[m]); k < netlist.outEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.bandwidth != 0) {
+            edge.from = moved[m];
+            edge.to = c.peer;
+            edge.bandwidth = c.fixedBandwidth;
+            trial.edges.push_back(edge);
+         }
+      }
+      for (int k = netlist.inBegin(moved[m]); k < netlist.inEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getIn(k);
+         if (c.bandwidth != 0 && c.peer != coreA && c.peer != coreB) {
+            edge.from = c.peer;
+            edge.to = moved[m];
+            edge.bandwidth = c.fixedBandwidth;
+            trial.edges.push_back(edge);
+         }
       }
    }
-}
 
-void Network::changeAllConnections(vector< vector<double> > &bandwidth, vector<Core> &core,
-      int index, int op) {
-   for (unsigned int i = 0; i < core.size(); i++) {
-      /*
-       * connection from core[index] to core[i]
-       */
-      if (bandwidth[index][i] != 0) {
-         changeConnection(core[index].getPosition(), core[i].getPosition(), op);
+   /*
+    * re-trace the moved connections
+    */
+   for (i = 0; i < trial.edges.size(); i++) {
+      edge = trial.edges[i];
+      r = getRoute(core[edge.from].getPosition(),
+            core[edge.to].getPosition(), length);
+      changeTrialRoute(r, length, edge.bandwidth, REMOVE);
+      r = getRoute(getTrialPosition(core, edge.from),
+            getTrialPosition(core, edge.to), length);
+      changeTrialRoute(r, length, edge.bandwidth, ADD);
+   }
+
+   /*
+    * utilization = current utilization + change of every changed router
+    * a router contributes only when it is a psudonode
+    */
+   uint8_t mask;
+   int conn, link, turn;
+   long long bw;
+   trial.util = utilization.getFixedUtil();
+   for (i = 0; i < trial.routerList.size(); i++) {
+      nodeId = trial.routerList[i];
+      const Router& router = routers[nodeId];
+      //only turns changed by the trial move can appear or disappear
+      mask = router.getTurnMask();
+      for (t = 0; t < MAX_TURNS; t++) {
+         turn = trial.turns[nodeId * MAX_TURNS + t];
+         if (turn != 0) {
+            if (router.getTurn(t) + turn > 0) {
+               mask |= (1 << t);
+            } else {
+               mask &= ~(1 << t);
+            }
+         }
       }
-      /*
-       * connection from core[i] to core[index]
-       */
-      if (bandwidth[i][index] != 0) {
-         changeConnection(core[i].getPosition(), core[index].getPosition(), op);
+      trial.psudonode[nodeId] = Router::psudonodeCondition(mask,
+            getTrialCoreIndex(nodeId) != NO_CORE);
+
+      for (t = 0; t < MAX_DIRECTION; t++) {
+         link = nodeId * MAX_DIRECTION + t;
+         conn = utilization.getConnection(nodeId, t);
+         bw = utilization.getBandwidth(nodeId, t);
+         if (router.isPsudonode()) {
+            trial.util -= conn * bw;
+         }
+         if (trial.psudonode[nodeId] && conn + trial.connection[link] != 0) {
+            trial.util += (conn + trial.connection[link]) * (bw
+                  + trial.bandwidth[link]);
+         }
       }
    }
+   trial.valid = true;
+   return (double) trial.util / utilization.getScale();
 }
 
-void Network::updateUtilization(vector< vector<double> > &bandwidth, vector<Core> &core) {
-   int nodeIdPrev, nodeIdCur;
-   Direction dir;
-   Coordinate prev, cur, dNode;
+double Network::evaluateUtilizationBound(const Netlist &netlist,
+      const vector<Core> &core, int coreA, int coreB) const {
+   int nodeId, length;
+   const RouteStep* r;
+   double bound = 0;
 
-   utilization.reset();
+   if (trial.turns.empty()) {
+      initTrial();
+   }
+   //a new stamp unmarks every router
+   if (++trial.boundStamp == 0) {
+      trial.boundMark.assign(row * col, 0);
+      trial.boundStamp = 1;
+   }
 
-   for (unsigned int start = 0; start < core.size(); start++) {
-      for (unsigned int dest = 0; dest < core.size(); dest++) {
-         /*
-          * has a connection
-          */
-         if (bandwidth[start][dest] != 0) {
-            prev = core[start].getPosition();
-            cur = core[start].getPosition();
-            dNode = core[dest].getPosition();
-            /*
-             * Move in x direction
-             */
-            while (cur.x != dNode.x) {
-               if (cur.x < dNode.x) { //go right
-                  cur.x++;
-               } else { //go left
-                  cur.x--;
-               }
-               /*
-                * If current router position is a psudonode
-                * add connection to utilization matrix
-                */
-               if (routers[cur.y][cur.x].isPsudonode()) {
-                  nodeIdPrev = prev.y * col + prev.x;
-                  nodeIdCur = cur.y * col + cur.x;
-                  dir = getDirection(prev, cur);
-                  if (dir != NO_DIR) {
-                     utilization.addConnection(nodeIdPrev, dir, nodeIdCur,
-                           bandwidth[start][dest]);
-                     prev = cur;
-                  }
-               }
+   /*
+    * routers of the moved cores
+    * then routers on the current routes of connections from/to them
+    */
+   int moved[2] = { coreA, coreB };
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE) {
+         continue;
+      }
+      Coordinate pos = core[moved[m]].getPosition();
+      nodeId = pos.y * col + pos.x;
+      if (trial.boundMark[nodeId] != trial.boundStamp) {
+         trial.boundMark[nodeId] = trial.boundStamp;
+         bound -= utilization.getNodeUtil(nodeId);
+      }
+      for (int k = netlist.outBegin(moved[m]); k < netlist.outEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.bandwidth == 0) {
+            continue;
+         }
+         r = getRoute(pos, core[c.peer].getPosition(), length);
+         for (int i = 0; i < length; i++) {
+            nodeId = RouteTable::getNode(r[i]);
+            if (trial.boundMark[nodeId] != trial.boundStamp) {
+               trial.boundMark[nodeId] = trial.boundStamp;
+               bound -= utilization.getNodeUtil(nodeId);
             }
-            /*
-             * Move in y direction
-             */
-            while (cur.y != dNode.y) {
-               if (cur.y < dNode.y) { //go up
-                  cur.y++;
-               } else { //go down 
-                  cur.y--;
-               }
-               /*
-                * If current router position is a psudonode
-                * add connection to utilization matrix
-                */
-               if (routers[cur.y][cur.x].isPsudonode()) {
-                  nodeIdPrev = prev.y * col + prev.x;
-                  nodeIdCur = cur.y * col + cur.x;
-                  dir = getDirection(prev, cur);
-                  if (dir != NO_DIR) {
-                     utilization.addConnection(nodeIdPrev, dir, nodeIdCur,
-                           bandwidth[start][dest]);
-                     prev = cur;
-                  }
-               }
+         }
+      }
+      for (int k = netlist.inBegin(moved[m]); k < netlist.inEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getIn(k);
+         if (c.bandwidth == 0) {
+            continue;
+         }
+         r = getRoute(core[c.peer].getPosition(), pos, length);
+         for (int i = 0; i < length; i++) {
+            nodeId = RouteTable::getNode(r[i]);
+            if (trial.boundMark[nodeId] != trial.boundStamp) {
+               trial.boundMark[nodeId] = trial.boundStamp;
+               bound -= utilization.getNodeUtil(nodeId);
             }
          }
       }
    }
+   return bound;
 }
 
-double Network::calculateUtilization() {
-   return utilization.calculateUtil();
+bool Network::hasTrial(int coreA, Coordinate newPosA, int coreB,
+      Coordinate newPosB) const {
+   if (!trial.valid || trial.coreA != coreA || trial.coreB != coreB) {
+      return false;
+   }
+   if (trial.posA.x != newPosA.x || trial.posA.y != newPosA.y) {
+      return false;
+   }
+   return coreB == NO_CORE || (trial.posB.x == newPosB.x && trial.posB.y
+         == newPosB.y);
 }
 
-Direction Network::getDirection(Coordinate from, Coordinate to) {
-   if (from.x < to.x) {
-      return RIGHT;
-   } else if (from.x > to.x) {
-      return LEFT;
-   } else {
-      if (from.y < to.y) {
-         return TOP;
-      } else if (from.y > to.y) {
-         return BOTTOM;
-      } else {
-         return NO_DIR;
+void Network::commitMove() {
+   int nodeId, link;
+   assert(trial.valid);
+   for (unsigned int i = 0; i < trial.routerList.size(); i++) {
+      nodeId = trial.routerList[i];
+      /*
+       * turn changes of every re-traced connection are applied at once,
+       * adding and removing the same turn cancel each other
+       */
+      routers[nodeId].changeTurns(&trial.turns[nodeId * MAX_TURNS],
+            getTrialCoreIndex(nodeId));
+      occupied.set(nodeId, routers[nodeId].getCoreIndex() != NO_CORE);
+      assert(routers[nodeId].isPsudonode() == (bool) trial.psudonode[nodeId]);
+      for (int t = 0; t < MAX_DIRECTION; t++) {
+         link = nodeId * MAX_DIRECTION + t;
+         if (trial.connection[link] != 0 || trial.bandwidth[link] != 0) {
+            utilization.changeLink(nodeId, t, trial.connection[link],
+                  trial.bandwidth[link]);
+         }
       }
+      utilization.setPsudonode(nodeId, trial.psudonode[nodeId]);
+   }
+   trial.valid = false;
+}
+
+long long Network::getRouteSteps() const {
+   return routeSteps;
+}
+
+int Network::getTrialCoreIndex(int nodeId) const {
+   int index = routers[nodeId].getCoreIndex();
+   /*
+    * moved cores are removed from their old positions
+    * and placed on their new positions
+    */
+   if (nodeId == trial.oldPosA.y * col + trial.oldPosA.x) {
+      index = NO_CORE;
+   }
+   if (trial.coreB != NO_CORE) {
+      if (nodeId == trial.oldPosB.y * col + trial.oldPosB.x) {
+         index = NO_CORE;
+      }
+      if (nodeId == trial.posB.y * col + trial.posB.x) {
+         index = trial.coreB;
+      }
+   }
+   if (nodeId == trial.posA.y * col + trial.posA.x) {
+      index = trial.coreA;
+   }
+   return index;
+}
+
+Coordinate Network::getTrialPosition(const vector<Core> &core, int index) const {
+   if (index == trial.coreA) {
+      return trial.posA;
+   } else if (index == trial.coreB) {
+      return trial.posB;
+   }
+   return core[index].getPosition();
+}
+
+void Network::markTrialRouter(int nodeId) const {
+   if (!trial.routerMark[nodeId]) {
+      trial.routerMark[nodeId] = true;
+      trial.routerList.push_back(nodeId);
+   }
+}
+
+void Network::changeTrialRoute(const RouteStep* r, int length, long long bw,
+      int op) const {
+   int nodeId, link;
+   int count = (op == ADD) ? 1 : -1;
+   for (int i = 0; i < length; i++) {
+      nodeId = RouteTable::getNode(r[i]);
+      markTrialRouter(nodeId);
+      //steps are packed as nodeId * MAX_TURNS + turn
+      trial.turns[r[i]] += count;
+      link = nodeId * MAX_DIRECTION + Router::getOutput(RouteTable::getTurn(
+            r[i]));
+      trial.connection[link] += count;
+      trial.bandwidth[link] += count * bw;
    }
 }
 
@@ -251,8 +506,8 @@ void Network::printNetwork() const {
       for (int j = 0; j < col; j++) {
          cout << setw(2) << i << "," << setw(2) << j << " = ";
          for (int k = 0; k < 8; k++) {
-            if (routers[i][j].getTurn(k) != 0) {
-               cout << routers[i][j].getTurn(k) << " ";
+            if (routers[i * col + j].getTurn(k) != 0) {
+               cout << routers[i * col + j].getTurn(k) << " ";
             } else {
                cout << "  ";
             }
@@ -266,7 +521,7 @@ void Network::printNetwork() const {
    cout << "psudo nodes\n";
    for (int i = 0; i < row; i++) {
       for (int j = 0; j < col; j++) {
-         if (routers[i][j].isPsudonode()) {
+         if (routers[i * col + j].isPsudonode()) {
             cout << j << "-" << i << endl;
          }
       }
@@ -279,13 +534,14 @@ void Network::showDiagram() const {
       cout << "#     ";
       //draw top link only
       for (int c = 0; c < col; c++) {
+         const Router& router = routers[r * col + c];
          //check that current router has outgoing link to the top router
-         if (routers[r][c].getTurn(BOTTOM_TOP) > 0 || routers[r][c].getTurn(
-               LEFT_TOP) > 0 || routers[r][c].getTurn(RIGHT_TOP) > 0) {
+         if (router.getTurn(BOTTOM_TOP) > 0 || router.getTurn(
+               LEFT_TOP) > 0 || router.getTurn(RIGHT_TOP) > 0) {
             cout << setw(3) << "|";
-         } else if ((r < row - 1) && (routers[r + 1][c].getTurn(TOP_BOTTOM) > 0
-               || routers[r + 1][c].getTurn(LEFT_BOTTOM) > 0
-               || routers[r + 1][c].getTurn(RIGHT_BOTTOM) > 0)) {
+         } else if ((r < row - 1) && (routers[(r + 1) * col + c].getTurn(TOP_BOTTOM) > 0
+               || routers[(r + 1) * col + c].getTurn(LEFT_BOTTOM) > 0
+               || routers[(r + 1) * col + c].getTurn(RIGHT_BOTTOM) > 0)) {
             //check that the top router has outgoing link to the bottom router (current router)
             cout << setw(3) << "|";
          } else {
@@ -298,8 +554,9 @@ void Network::showDiagram() const {
       cout << "#" << setw(3) << r << "  ";
       //draw right side link only
       for (int c = 0; c < col; c++) {
-         if (routers[r][c].isPsudonode()) {
-            index = routers[r][c].getCoreIndex();
+         const Router& router = routers[r * col + c];
+         if (router.isPsudonode()) {
+            index = router.getCoreIndex();
             if (index != NO_CORE) {
                cout << setw(3) << index + 1;
             } else {
@@ -310,11 +567,11 @@ void Network::showDiagram() const {
          }
          //check that the current router position has output to right side (L->R)
          //or input from the right side (R->B), (R->T)
-         if (routers[r][c].getTurn(LEFT_RIGHT) > 0 || routers[r][c].getTurn(
-               RIGHT_TOP) > 0 || routers[r][c].getTurn(RIGHT_BOTTOM) > 0) {
+         if (router.getTurn(LEFT_RIGHT) > 0 || router.getTurn(
+               RIGHT_TOP) > 0 || router.getTurn(RIGHT_BOTTOM) > 0) {
             cout << "----";
          } else if ((c < col - 1)
-               && (routers[r][c + 1].getTurn(RIGHT_LEFT) > 0)) {
+               && (routers[r * col + c + 1].getTurn(RIGHT_LEFT) > 0)) {
             //check that the next right router has outgoint connection from to this router
             cout << "----";
          } else {
@@ -2,13 +2,67 @@
 #define NETWORK_HPP
 
 #include <vector>
+#include <utility>
+#include <memory>
 
 #include "Defs.hpp"
 #include "Router.hpp"
 #include "Core.hpp"
 #include "Utilization.hpp"
+#include "Netlist.hpp"
+#include "RouteTable.hpp"
+#include "Bitboard.hpp"
 
 using std::vector;
+using std::pair;
+using std::shared_ptr;
+
+/*
+ * Connection from core "from" to core "to" re-traced by a trial move
+ */
+struct TrialEdge {
+   int from;
+   int to;
+   long long bandwidth;
+};
+
+/*
+ * Changes of a move that is evaluated but not yet applied to the network
+ * - core[coreA] is placed at posA and core[coreB] (if any) at posB
+ * - edges lists connections from/to the moved cores
+ * - turns holds change in turn counts, MAX_TURNS entries per router
+ * - connection and bandwidth hold change in links leaving the routers,
+ *   MAX_DIRECTION entries per router
+ * - psudonode holds psudonode condition of the changed routers
+ * - routerList lists the changed routers
+ * - boundMark marks routers counted by evaluateUtilizationBound,
+ *   a router is marked when its entry equals boundStamp
+ * The changes are scratch data of a network so they are not copied
+ * with the network, a copy starts with an empty trial move
+ */
+struct TrialMove {
+   TrialMove();
+   TrialMove(const TrialMove& other);
+   TrialMove& operator=(const TrialMove& other);
+
+   bool valid;
+   int coreA;
+   int coreB;
+   Coordinate posA;
+   Coordinate posB;
+   Coordinate oldPosA;
+   Coordinate oldPosB;
+   vector<TrialEdge> edges;
+   vector<int> turns;
+   vector<int> connection;
+   vector<long long> bandwidth;
+   vector<char> psudonode;
+   vector<int> routerList;
+   vector<char> routerMark;
+   vector<int> boundMark;
+   int boundStamp;
+   long long util;
+};
 
 class Network{
    public:
@@ -17,8 +71,14 @@ class Network{
 
       /*
        * Initialize network
+       * bandwidth is in units of 1 / "scale"
+       */
+      void init(int r, int c, long long scale = FIXED_POINT_SCALE);
+      /*
+       * get size of the mesh
        */
-      void init(int r, int c);
+      int getRow() const;
+      int getCol() const;
       /*
        * place a core to a network
        */
@@ -38,26 +98,64 @@ class Network{
        */
       bool hasCore(Coordinate pos);
       /*
-       * add/remove connection from a network
-       * op specifies operation ADD/REMOVE
+       * get the set of routers that have a core, indexed by nodeId
        */
-      void changeConnection(Coordinate from, Coordinate to, int op);
+      const Bitboard& getOccupancy() const;
       /*
-       * change all connections to and from core[index]
+       * add/remove connection from a network
        * op specifies operation ADD/REMOVE
        */
-      void changeAllConnections(vector< vector<double> > &bandwidth, vector<Core> &core, int index, int op);
+      void changeConnection(Coordinate from, Coordinate to, int op);
 
       //bool isLegal(int LINK_BANDWIDTH);
 
       /*
        * Update utilization matrix by tracing route of all connections
        */
-      void updateUtilization(vector< vector<double> > &bandwidth, vector<Core> &core);
+      void updateUtilization(const Netlist &netlist, const vector<Core> &core);
       /*
        * calculate utilization using utilization matrix
        */
       double calculateUtilization();
+      /*
+       * get utilization maintained by updateUtilization and commitMove
+       */
+      double getUtilization() const;
+      /*
+       * Evaluate utilization when core[coreA] is placed at "newPosA"
+       * and core[coreB] (if any) is placed at "newPosB".
+       * Only connections from/to the moved cores are re-traced, routers
+       * that change psudonode condition only add or remove their own links.
+       * The network is not modified, the changes are kept as a trial move
+       */
+      double evaluateUtilization(const Netlist &netlist, const vector<Core> &core, int coreA,
+            Coordinate newPosA, int coreB, Coordinate newPosB) const;
+      /*
+       * Lower bound of the change in utilization when core[coreA]
+       * and core[coreB] (if any) are moved, wherever they are moved to.
+       * Only routers on the current routes of the moved connections and
+       * routers of the moved cores can lose utilization, each at most all
+       * of it. Turns added by the new routes never remove a psudonode.
+       */
+      double evaluateUtilizationBound(const Netlist &netlist, const vector<Core> &core, int coreA,
+            int coreB) const;
+      /*
+       * check if the trial move places core[coreA] at "newPosA"
+       * and core[coreB] at "newPosB"
+       */
+      bool hasTrial(int coreA, Coordinate newPosA, int coreB, Coordinate newPosB) const;
+      /*
+       * Apply the trial move to the network
+       * - moved cores are placed on their new positions
+       * - turn counts and links of the changed routers are updated
+       *   and their psudonode condition is checked once
+       */
+      void commitMove();
+      /*
+       * number of route steps traced so far, a measure of the work done
+       * by evaluating and applying moves that does not depend on timing
+       */
+      long long getRouteSteps() const;
       /*
        * printing turn counts for each router
        * and list of psudonodes
@@ -77,13 +175,57 @@ class Network{
       int row;
       int col;
       bool legal;
-      vector< vector<Router> > routers;
+      /*
+       * routers indexed by nodeId = y * col + x
+       */
+      vector<Router> routers;
       Utilization utilization;
+      /*
+       * routers that have a core
+       */
+      Bitboard occupied;
+
+      /*
+       * evaluated move and scratch used by evaluateUtilization
+       */
+      mutable TrialMove trial;
+      /*
+       * XY routes of the mesh, shared by copies of the network
+       */
+      shared_ptr<RouteTable> routeTable;
+      /*
+       * route steps returned by getRoute
+       */
+      mutable long long routeSteps;
 
       /*
-       * get a direction that would take you from "from" to "to"
+       * get route from "from" to "to"
+       * length is set to the number of routers on the route
+       * except the destination
+       * the route is valid until the next call
+       */
+      const RouteStep* getRoute(Coordinate from, Coordinate to, int& length) const;
+      /*
+       * core index of a router after the trial move
+       */
+      int getTrialCoreIndex(int nodeId) const;
+      /*
+       * position of core[index] after the trial move
+       */
+      Coordinate getTrialPosition(const vector<Core> &core, int index) const;
+      /*
+       * allocate changes of the trial move
+       */
+      void initTrial() const;
+      /*
+       * add a router to the list of routers changed by the trial move
+       */
+      void markTrialRouter(int nodeId) const;
+      /*
+       * add or remove route of a connection with bandwidth "bw"
+       * to the trial move, op specifies operation ADD/REMOVE
        */
-      Direction getDirection(Coordinate from, Coordinate to);
+      void changeTrialRoute(const RouteStep* r, int length, long long bw, int op) const;
 };
 
 #endif
@@ -0,0 +1,137 @@
+#include <fstream>
+#include <cmath>
+#include <climits>
+#include <stdint.h>
+
+#include "Problem.hpp"
+
+using namespace std;
+
+Problem::Problem() {
+   LINK_BANDWIDTH = 0;
+   LINK_LATENCY = 0;
+   meshRow = 0;
+   meshCol = 0;
+   bandwidthExact = true;
+}
+
+Problem::~Problem() {
+}
+
+int Problem::load(char* filename) {
+   int numCore = 0;
+
+   ifstream file(filename);
+   if (!file.is_open()) {
+      return FILE_OPEN_ERR;
+   }
+
+   file >> LINK_BANDWIDTH >> LINK_LATENCY >> meshRow >> meshCol >> numCore;
+   if (meshRow <= 0 || meshCol <= 0 || numCore <= 0) {
+      return INPUT_ERR;
+   }
+
+   /*
+    * Read initial core positions
+    */
+   Coordinate pos;
+   pos.x = 0;
+   pos.y = 0;
+   initialPosition.clear();
+   for (int i = 0; i < numCore; i++) {
+      if (file.good()) {
+         file >> pos.x >> pos.y;
+      }
+      if (pos.x < 0 || pos.x >= meshCol || pos.y < 0 || pos.y >= meshRow) {
+         return INPUT_ERR;
+      }
+      initialPosition.push_back(pos);
+   }
+
+   /*
+    * Read the connections from file
+    * Initialize the adjacency lists of the netlist
+    */
+   int from, to;
+   double bw, laten;
+   long long scale = FIXED_POINT_SCALE;
+   double totalBandwidth = 0;
+   int numRead = 0;
+   netlist.init(numCore);
+   while (file >> from >> to >> bw >> laten) {
+      //cores are numbered from 1 in the input
+      if (from < 1 || from > numCore || to < 1 || to > numCore) {
+         return INPUT_ERR;
+      }
+      //the scale grows until every bandwidth is represented exactly
+      while (scale < MAX_FIXED_POINT_SCALE && !isExact(bw, scale)) {
+         scale *= 10;
+      }
+      totalBandwidth += fabs(bw);
+      numRead++;
+      netlist.addConnection(from - 1, to - 1, bw, laten);
+   }
+   /*
+    * a link carries at most every connection and a route is shorter
+    * than meshRow + meshCol hops, the scale is lowered until the integer
+    * sums of compaction and utilization cannot overflow
+    */
+   while (scale > FIXED_POINT_SCALE && totalBandwidth * scale * numRead
+         * (meshRow + meshCol) > LLONG_MAX / 2) {
+      scale /= 10;
+   }
+   netlist.build(LINK_LATENCY, scale);
+   bandwidthExact = true;
+   for (int k = 0; k < netlist.getNumConnection(); k++) {
+      if (!isExact(netlist.getOut(k).bandwidth, scale)) {
+         bandwidthExact = false;
+      }
+   }
+   /*
+    * a turn of a router is counted once for every route through it,
+    * so the number of connections bounds the 16-bit turn counts
+    */
+   if (netlist.getNumConnection() > INT16_MAX) {
+      return CONNECTION_ERR;
+   }
+
+   file.close();
+
+   return NO_ERR;
+}
+
+double Problem::getLinkBandwidth() const {
+   return LINK_BANDWIDTH;
+}
+
+double Problem::getLinkLatency() const {
+   return LINK_LATENCY;
+}
+
+int Problem::getMeshRow() const {
+   return meshRow;
+}
+
+int Problem::getMeshCol() const {
+   return meshCol;
+}
+
+int Problem::getNumCore() const {
+   return initialPosition.size();
+}
+
+Coordinate Problem::getInitialPosition(int index) const {
+   return initialPosition[index];
+}
+
+const Netlist& Problem::getNetlist() const {
+   return netlist;
+}
+
+bool Problem::isBandwidthExact() const {
+   return bandwidthExact;
+}
+
+bool Problem::isExact(double bandwidth, long long scale) {
+   return llround(bandwidth * scale) / (double) scale == bandwidth;
+}
@@ -0,0 +1,75 @@
+#ifndef PROBLEM_HPP
+#define PROBLEM_HPP
+
+#include <vector>
+
+#include "Defs.hpp"
+#include "Netlist.hpp"
+
+using std::vector;
+
+/*
+ * Input of a placement problem
+ * - link bandwidth and latency
+ * - mesh size
+ * - initial core positions
+ * - connections between cores
+ * A problem is read once and is not changed afterwards, so it is
+ * shared by every state that places its cores
+ */
+class Problem {
+   public:
+      Problem();
+      ~Problem();
+
+      /*
+       * Read a problem from an input file
+       * the netlist keeps bandwidth in fixed point at the smallest scale
+       * that represents every bandwidth exactly, up to MAX_FIXED_POINT_SCALE
+       * INPUT_ERR is returned when the mesh or the number of cores is not
+       * positive, a core is placed outside the mesh or a connection refers
+       * to a core that does not exist
+       * CONNECTION_ERR is returned when there are more connections than
+       * the turn count of a router can hold
+       */
+      int load(char* filename);
+
+      double getLinkBandwidth() const;
+      double getLinkLatency() const;
+      int getMeshRow() const;
+      int getMeshCol() const;
+      /*
+       * get number of cores
+       */
+      int getNumCore() const;
+      /*
+       * get initial position of core[index]
+       */
+      Coordinate getInitialPosition(int index) const;
+      /*
+       * get connections between cores
+       */
+      const Netlist& getNetlist() const;
+      /*
+       * check whether every bandwidth is represented exactly
+       * by the fixed point bandwidth of the netlist
+       */
+      bool isBandwidthExact() const;
+
+   private:
+      double LINK_BANDWIDTH;
+      double LINK_LATENCY;
+      int meshRow;
+      int meshCol;
+
+      vector<Coordinate> initialPosition;
+      bool bandwidthExact;
+      Netlist netlist;
+
+      /*
+       * check whether "bandwidth" is a multiple of 1 / "scale"
+       */
+      static bool isExact(double bandwidth, long long scale);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "RandomGenerator.hpp"
+
+RandomGenerator::RandomGenerator() {
+   seed(0);
+}
+
+RandomGenerator::RandomGenerator(uint64_t seed, int stream) {
+   this->seed(seed, stream);
+}
+
+RandomGenerator::~RandomGenerator() {
+}
+
+void RandomGenerator::seed(uint64_t seed, int stream) {
+   /*
+    * the state is filled by splitmix64 so that similar seeds
+    * give unrelated sequences and the state is never all zero
+    */
+   uint64_t z;
+   for (int i = 0; i < 4; i++) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      s[i] = z ^ (z >> 31);
+   }
+   for (int i = 0; i < stream; i++) {
+      jump();
+   }
+}
+
+void RandomGenerator::jump() {
+   static const uint64_t JUMP[4] = { 0x180ec6d33cfd0abaULL,
+         0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+   uint64_t t[4] = { 0, 0, 0, 0 };
+   for (int i = 0; i < 4; i++) {
+      for (int b = 0; b < 64; b++) {
+         if (JUMP[i] & ((uint64_t) 1 << b)) {
+            for (int k = 0; k < 4; k++) {
+               t[k] ^= s[k];
+            }
+         }
+         next();
+      }
+   }
+   for (int k = 0; k < 4; k++) {
+      s[k] = t[k];
+   }
+}
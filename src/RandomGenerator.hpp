@@ -0,0 +1,92 @@
+#ifndef RANDOMGENERATOR_HPP
+#define RANDOMGENERATOR_HPP
+
+#include <stdint.h>
+#include <cassert>
+
+/*
+ * Random number generator of a simulated annealing run (xoshiro256**)
+ * - the sequence only depends on the seed and the stream
+ *   so runs are reproducible however many of them run together
+ * - stream k starts 2^128 numbers after stream k - 1 of the same seed,
+ *   streams of a seed do not overlap
+ */
+class RandomGenerator {
+   public:
+      RandomGenerator();
+      RandomGenerator(uint64_t seed, int stream = 0);
+      ~RandomGenerator();
+
+      /*
+       * restart the sequence of stream "stream" of "seed"
+       */
+      void seed(uint64_t seed, int stream = 0);
+      /*
+       * skip 2^128 numbers, moving to the next stream
+       */
+      void jump();
+      /*
+       * Generate uniform random number in [0,1) interval
+       */
+      double uniform_0_1();
+      /*
+       * Generate uniform random number in [0,n) interval
+       * every number is equally likely
+       */
+      int uniform_n(int n);
+      /*
+       * Generate uniform random 64-bit number
+       */
+      uint64_t uniform_64();
+
+   private:
+      uint64_t s[4];
+
+      uint64_t next();
+      static uint64_t rotl(uint64_t x, int k);
+};
+
+inline uint64_t RandomGenerator::rotl(uint64_t x, int k) {
+   return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t RandomGenerator::next() {
+   uint64_t result = rotl(s[1] * 5, 7) * 9;
+   uint64_t t = s[1] << 17;
+   s[2] ^= s[0];
+   s[3] ^= s[1];
+   s[1] ^= s[2];
+   s[0] ^= s[3];
+   s[2] ^= t;
+   s[3] = rotl(s[3], 45);
+   return result;
+}
+
+inline double RandomGenerator::uniform_0_1() {
+   //53 high bits fill the mantissa of a double
+   return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+inline uint64_t RandomGenerator::uniform_64() {
+   return next();
+}
+
+inline int RandomGenerator::uniform_n(int n) {
+   /*
+    * the high 32 bits of x * n are in [0,n)
+    * the low 32 bits tell whether x is in the part of the range
+    * that would make some numbers more likely, x is then drawn again
+    */
+   assert(n > 0);
+   uint32_t bound = (uint32_t) n;
+   uint64_t m = (next() >> 32) * bound;
+   if ((uint32_t) m < bound) {
+      uint32_t threshold = -bound % bound;
+      while ((uint32_t) m < threshold) {
+         m = (next() >> 32) * bound;
+      }
+   }
+   return (int) (m >> 32);
+}
+
+#endif
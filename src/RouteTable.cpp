@@ -0,0 +1,182 @@
+#include <cassert>
+#include <cstddef>
+
+#include "RouteTable.hpp"
+#include "Utils.hpp"
+
+using namespace std;
+
+RouteTable::RouteTable() {
+   row = 0;
+   col = 0;
+   size = 0;
+   cached = false;
+   maxLength = 0;
+   used = 0;
+   head = -1;
+   tail = -1;
+}
+
+RouteTable::~RouteTable() {
+}
+
+void RouteTable::init(int r, int c) {
+   row = r;
+   col = c;
+   size = r * c;
+   cached = size > ROUTE_TABLE_MAX_NODE;
+
+   nodePosition = vector<Coordinate> (size);
+   for (int n = 0; n < size; n++) {
+      nodePosition[n].x = n % col;
+      nodePosition[n].y = n / col;
+   }
+
+   offset.clear();
+   steps.clear();
+   slotSteps.clear();
+   slotLength.clear();
+   slotKey.clear();
+   prev.clear();
+   next.clear();
+   slotOf.clear();
+   used = 0;
+   head = -1;
+   tail = -1;
+
+   //a route has at most (col - 1) + (row - 1) steps
+   maxLength = (r - 1) + (c - 1);
+   if (!cached) {
+      offset = vector<int> (size * size, -1);
+   } else {
+      slotSteps = vector<RouteStep> ((size_t) ROUTE_CACHE_SIZE * maxLength);
+      slotLength = vector<int> (ROUTE_CACHE_SIZE);
+      slotKey = vector<long long> (ROUTE_CACHE_SIZE);
+      prev = vector<int> (ROUTE_CACHE_SIZE);
+      next = vector<int> (ROUTE_CACHE_SIZE);
+   }
+}
+
+const RouteStep* RouteTable::getRoute(int from, int to, int& length) {
+   assert(from >= 0 && from < size);
+   assert(to >= 0 && to < size);
+
+   if (from == to) {
+      length = 0;
+      return NULL;
+   }
+
+   if (!cached) {
+      int& off = offset[from * size + to];
+      if (off == -1) {
+         off = steps.size();
+         steps.resize(off + maxLength);
+         steps.resize(off + trace(from, to, &steps[off]));
+      }
+      length = getHops(nodePosition[from], nodePosition[to]);
+      return &steps[off];
+   }
+
+   long long key = (long long) from * size + to;
+   unordered_map<long long, int>::iterator it = slotOf.find(key);
+   int slot;
+   if (it != slotOf.end()) {
+      //most recently used route
+      slot = it->second;
+      unlink(slot);
+   } else {
+      if (used < ROUTE_CACHE_SIZE) {
+         slot = used++;
+      } else {
+         //replace the least recently used route
+         slot = tail;
+         unlink(slot);
+         slotOf.erase(slotKey[slot]);
+      }
+      slotKey[slot] = key;
+      slotLength[slot] = trace(from, to, &slotSteps[(size_t) slot * maxLength]);
+      slotOf[key] = slot;
+   }
+   pushFront(slot);
+   length = slotLength[slot];
+   return &slotSteps[(size_t) slot * maxLength];
+}
+
+int RouteTable::trace(int from, int to, RouteStep* r) const {
+   int n = 0;
+   int x = nodePosition[from].x, y = nodePosition[from].y;
+   int toX = nodePosition[to].x, toY = nodePosition[to].y;
+
+   /*
+    * Move in x direction
+    */
+   while (x != toX) {
+      if (x < toX) { //go right
+         r[n++] = (y * col + x) * MAX_TURNS + LEFT_RIGHT;
+         x++;
+      } else { //go left
+         r[n++] = (y * col + x) * MAX_TURNS + RIGHT_LEFT;
+         x--;
+      }
+   }
+
+   /*
+    * Turn
+    */
+   int fromX = nodePosition[from].x, fromY = nodePosition[from].y;
+   if (fromX < toX) { //from left
+      if (fromY < toY) { //go up
+         r[n++] = (y * col + x) * MAX_TURNS + LEFT_TOP;
+         y++;
+      } else if (fromY > toY) { //go down
+         r[n++] = (y * col + x) * MAX_TURNS + LEFT_BOTTOM;
+         y--;
+      }
+   } else if (fromX > toX) { //from right
+      if (fromY < toY) { //go up
+         r[n++] = (y * col + x) * MAX_TURNS + RIGHT_TOP;
+         y++;
+      } else if (fromY > toY) { //go down
+         r[n++] = (y * col + x) * MAX_TURNS + RIGHT_BOTTOM;
+         y--;
+      }
+   }
+
+   /*
+    * Move in y direction
+    */
+   while (y != toY) {
+      if (y < toY) { //go up
+         r[n++] = (y * col + x) * MAX_TURNS + BOTTOM_TOP;
+         y++;
+      } else { //go down
+         r[n++] = (y * col + x) * MAX_TURNS + TOP_BOTTOM;
+         y--;
+      }
+   }
+   return n;
+}
+
+void RouteTable::unlink(int i) {
+   if (prev[i] != -1) {
+      next[prev[i]] = next[i];
+   } else {
+      head = next[i];
+   }
+   if (next[i] != -1) {
+      prev[next[i]] = prev[i];
+   } else {
+      tail = prev[i];
+   }
+}
+
+void RouteTable::pushFront(int i) {
+   prev[i] = -1;
+   next[i] = head;
+   if (head != -1) {
+      prev[head] = i;
+   } else {
+      tail = i;
+   }
+   head = i;
+}
@@ -0,0 +1,105 @@
+#ifndef ROUTETABLE_HPP
+#define ROUTETABLE_HPP
+
+#include <vector>
+#include <unordered_map>
+
+#include "Defs.hpp"
+
+//meshes up to this number of nodes keep every traced route
+#define ROUTE_TABLE_MAX_NODE 1024
+//number of routes kept for larger meshes
+#define ROUTE_CACHE_SIZE 65536
+
+using std::vector;
+using std::unordered_map;
+
+/*
+ * A step of a route, router "nodeId" and turn "t" the route takes
+ * they are packed into nodeId * MAX_TURNS + t
+ */
+typedef int RouteStep;
+
+/*
+ * Table of XY routes between every pair of nodes of a mesh
+ * A route is traced the first time it is asked for and kept as
+ * a sequence of steps for every router on the route except the destination.
+ * - meshes up to ROUTE_TABLE_MAX_NODE nodes keep every route in a table
+ * - larger meshes keep the ROUTE_CACHE_SIZE routes used most recently
+ */
+class RouteTable {
+   public:
+      RouteTable();
+      ~RouteTable();
+
+      /*
+       * Initialize an empty table for a mesh of size r x c
+       */
+      void init(int r, int c);
+      /*
+       * get route from node "from" to node "to"
+       * length is set to the number of steps of the route
+       * the steps are valid until the next call
+       */
+      const RouteStep* getRoute(int from, int to, int& length);
+      /*
+       * get router and turn of a step
+       */
+      static int getNode(RouteStep s);
+      static int getTurn(RouteStep s);
+
+   private:
+      int row;
+      int col;
+      int size;
+      bool cached;
+      /*
+       * position of every node, so that a lookup does not divide by col
+       */
+      vector<Coordinate> nodePosition;
+
+      /*
+       * table of every route
+       * offset of the first step of route (from, to) in "steps"
+       * or -1 when the route is not traced yet
+       */
+      vector<int> offset;
+      vector<RouteStep> steps;
+
+      /*
+       * least recently used cache
+       * slot i keeps its steps in [i * maxLength, (i + 1) * maxLength)
+       * slots are linked from the most to the least recently used one
+       */
+      int maxLength;
+      int used;
+      int head;
+      int tail;
+      vector<RouteStep> slotSteps;
+      vector<int> slotLength;
+      vector<long long> slotKey;
+      vector<int> prev;
+      vector<int> next;
+      unordered_map<long long, int> slotOf;
+
+      /*
+       * trace XY route from node "from" to node "to" into "r"
+       * the number of steps is returned
+       */
+      int trace(int from, int to, RouteStep* r) const;
+      /*
+       * remove slot i from the list of slots / add it as the most recent one
+       */
+      void unlink(int i);
+      void pushFront(int i);
+};
+
+inline int RouteTable::getNode(RouteStep s) {
+   return s / MAX_TURNS;
+}
+
+inline int RouteTable::getTurn(RouteStep s) {
+   return s % MAX_TURNS;
+}
+
+#endif
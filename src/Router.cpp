@@ -4,10 +4,50 @@
 
 using namespace std;
 
+namespace {
+
+/*
+ * psudonode condition of a router without a core for every turn mask
+ */
+struct PsudonodeTable {
+   bool psudonode[1 << MAX_TURNS];
+
+   PsudonodeTable() {
+      /*
+       * Check for psudonode condition
+       * - same input different output
+       * - diff input same output
+       * a router is a psudonode when it has more than one turn
+       * of the same group
+       */
+      const int group[4] = {
+         (1 << LEFT_RIGHT) | (1 << LEFT_BOTTOM) | (1 << LEFT_TOP),
+         (1 << RIGHT_LEFT) | (1 << RIGHT_BOTTOM) | (1 << RIGHT_TOP),
+         (1 << TOP_BOTTOM) | (1 << LEFT_BOTTOM) | (1 << RIGHT_BOTTOM),
+         (1 << BOTTOM_TOP) | (1 << LEFT_TOP) | (1 << RIGHT_TOP)
+      };
+      for (int m = 0; m < (1 << MAX_TURNS); m++) {
+         psudonode[m] = false;
+         for (int g = 0; g < 4; g++) {
+            int turns = m & group[g];
+            //more than one bit is set
+            if ((turns & (turns - 1)) != 0) {
+               psudonode[m] = true;
+            }
+         }
+      }
+   }
+};
+
+const PsudonodeTable psudonodeTable;
+
+}
+
 Router::Router() {
    for (int i = 0; i < MAX_TURNS; i++) {
       turns[i] = 0;
    }
+   mask = 0;
    coreIndex = NO_CORE;
    psudonode = false;
 }
@@ -15,63 +55,72 @@ Router::Router() {
 Router::~Router() {
 }
 
-int Router::getTurn(int t) const{
-   assert(t >= 0 && t < 8);
-   return turns[t];
-}
-
 void Router::changeTurn(int t, int op) {
    assert(t >= 0 && t < 8);
    /*
     * op == add then we add turn count "t"
     * op == remove then we remove turn count "t"
+    * psudonode condition only changes when a turn
+    * appears or disappears
     */
-   (op == ADD) ? (turns[t]++) : (turns[t]--);
-   /*
-    * re-checking psudonode condition every time
-    * we change turn counts
-    */
+   if (op == ADD) {
+      assert(turns[t] < INT16_MAX);
+      if (++turns[t] == 1) {
+         mask |= (1 << t);
+         checkPsudonode();
+      }
+   } else {
+      if (--turns[t] == 0) {
+         mask &= ~(1 << t);
+         checkPsudonode();
+      }
+   }
+}
+
+void Router::changeTurns(const int count[MAX_TURNS], int index) {
+   for (int t = 0; t < MAX_TURNS; t++) {
+      if (count[t] == 0) {
+         continue;
+      }
+      assert(turns[t] + count[t] <= INT16_MAX);
+      turns[t] += count[t];
+      if (turns[t] > 0) {
+         mask |= (1 << t);
+      } else {
+         mask &= ~(1 << t);
+      }
+   }
+   coreIndex = index;
    checkPsudonode();
 }
 
 void Router::checkPsudonode() {
+   psudonode = psudonodeCondition(mask, coreIndex != NO_CORE);
+}
+
+bool Router::psudonodeCondition(uint8_t mask, bool hasCore) {
    /*
     * if router contains a core then it
     * automatically is a psudonode
     */
-   if (coreIndex != NO_CORE) {
-      psudonode = true;
-      return;
-   }
-   /*
-    * t corresponds to turn counts
-    * t[i] = 1 if the turn count[i] is not zero
-    */
-   int t[MAX_TURNS] = { 0 };
-   for (int i = 0; i < MAX_TURNS; i++) {
-      if (turns[i] > 0) {
-         t[i] = 1;
-      }
-   }
+   return hasCore || psudonodeTable.psudonode[mask];
+}
 
-   /*
-    * Check for psudonode condition
-    * - same input different output
-    * - diff input same output
-    * t[i] tells us whether a router has that turn or not
-    * so grouping and summing t[i] will tell us if
-    * the node is a psudonode or not
-    */
-   if ((t[LEFT_RIGHT] + t[LEFT_BOTTOM] + t[LEFT_TOP]) > 1) {
-      psudonode = true;
-   } else if ((t[RIGHT_LEFT] + t[RIGHT_BOTTOM] + t[RIGHT_TOP]) > 1) {
-      psudonode = true;
-   } else if ((t[TOP_BOTTOM] + t[LEFT_BOTTOM] + t[RIGHT_BOTTOM]) > 1) {
-      psudonode = true;
-   } else if ((t[BOTTOM_TOP] + t[LEFT_TOP] + t[RIGHT_TOP]) > 1) {
-      psudonode = true;
-   } else {
-      psudonode = false;
+Direction Router::getOutput(int t) {
+   assert(t >= 0 && t < 8);
+   switch (t) {
+   case BOTTOM_TOP:
+   case LEFT_TOP:
+   case RIGHT_TOP:
+      return TOP;
+   case TOP_BOTTOM:
+   case LEFT_BOTTOM:
+   case RIGHT_BOTTOM:
+      return BOTTOM;
+   case RIGHT_LEFT:
+      return LEFT;
+   default: //LEFT_RIGHT
+      return RIGHT;
    }
 }
 
@@ -1,6 +1,8 @@
 #ifndef ROUTER_HPP
 #define ROUTER_HPP
 
+#include <stdint.h>
+
 #include "Defs.hpp"
 
 class Router {
@@ -12,11 +14,22 @@ class Router {
        * get turn count of turn "t"
        */
       int getTurn(int t) const;
+      /*
+       * get turns that the router has
+       * bit t is set when turn count of turn "t" is not zero
+       */
+      uint8_t getTurnMask() const;
       /*
        * add or remove turn from a router
        * op is either ADD or REMOVE
        */
       void changeTurn(int t, int op);
+      /*
+       * change turn counts by "count[t]" for every turn "t"
+       * and place core[index] on the router
+       * psudonode condition is checked once after all the changes
+       */
+      void changeTurns(const int count[MAX_TURNS], int index);
       /*
        * check if a router is psudonode or not
        */
@@ -32,12 +45,23 @@ class Router {
        * of core vector
        */
       void setCore(int index);
+      /*
+       * check psudonode condition of a router with turns "mask"
+       * hasCore tells whether a core is placed on the router
+       */
+      static bool psudonodeCondition(uint8_t mask, bool hasCore);
+      /*
+       * get the direction that a connection leaves a router with turn "t"
+       */
+      static Direction getOutput(int t);
 
    private:
       //variable
-      int turns[MAX_TURNS];
-      int coreIndex;
+      //Problem::load bounds the number of connections by INT16_MAX
+      int16_t turns[MAX_TURNS];
+      uint8_t mask;
       bool psudonode;
+      int coreIndex;
 
       //function
       void checkPsudonode();
@@ -47,6 +71,14 @@ inline bool Router::isPsudonode() const {
    return psudonode;
 }
 
+inline int Router::getTurn(int t) const {
+   return turns[t];
+}
+
+inline uint8_t Router::getTurnMask() const {
+   return mask;
+}
+
 inline int Router::getCoreIndex() const {
    return coreIndex;
 }
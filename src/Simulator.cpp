@@ -5,11 +5,12 @@
 #include <sstream>
 
 #include "Simulator.hpp"
-#include "Utils.hpp"
 
 using namespace std;
 
 Simulator::Simulator() {
+   CHECK_INTERVAL = 0;
+   rangeLimit = false;
 }
 
 Simulator::~Simulator() {
@@ -18,6 +19,19 @@ Simulator::~Simulator() {
 int Simulator::init(double alpha, double beta, double gamma,
       double delta, double startTemp, double endTemp, double rate, int iter,
       int reject, int accept, char* inputfile, bool verbose, bool quiet) {
+   shared_ptr<Problem> problem(new Problem());
+   int err = problem->load(inputfile);
+   if (err != NO_ERR) {
+      return err;
+   }
+   return init(alpha, beta, gamma, delta, startTemp, endTemp, rate, iter,
+         reject, accept, problem, verbose, quiet);
+}
+
+int Simulator::init(double alpha, double beta, double gamma,
+      double delta, double startTemp, double endTemp, double rate, int iter,
+      int reject, int accept, shared_ptr<const Problem> problem, bool verbose,
+      bool quiet) {
    temp = startTemp;
    bestTemp = startTemp;
    END_TEMP = endTemp;
@@ -31,19 +45,59 @@ int Simulator::init(double alpha, double beta, double gamma,
    /*
     * Initialize intial state
     */
-   int err = currentState.init(alpha, beta, gamma, delta, inputfile);
+   int err = currentState.init(alpha, beta, gamma, delta, problem);
    if (err != 0) {
       return err;
    }
+   /*
+    * terms with zero weight are only evaluated
+    * when rejected moves are printed
+    */
+   currentState.setEvaluateAll(verbose);
+   //utilization of the best state is printed at every temperature
+   currentState.setKeepUtilization(!quiet);
    bestState = currentState;
+   currentState.saveSnapshot(best);
    return 0;
 }
 
+void Simulator::setFeasibleMove(bool enable) {
+   currentState.setFeasibleMove(enable);
+}
+
+void Simulator::setRangeLimit(bool enable) {
+   rangeLimit = enable;
+   currentState.setRangeLimit(enable);
+   selector.init();
+}
+
+void Simulator::setHotCore(bool enable) {
+   currentState.setHotCore(enable);
+}
+
+void Simulator::setSeed(unsigned int seed, int stream) {
+   random.seed(seed, stream);
+}
+
+void Simulator::setCheckInterval(int interval) {
+   CHECK_INTERVAL = interval;
+}
+
+bool Simulator::setTranspositionTable(int bits) {
+   return currentState.setTranspositionTable(bits);
+}
+
 void Simulator::run() {
-   int cReject, cAccept, iterations;
-   double changeCost;
+   int cReject, cAccept, numChange, iterations;
+   int numApplied = 0;
+   double drift;
+   double threshold;
    bool setCurrent = false;
-   double random, prob;
+   double randomNum;
+   CostDelta change;
+   int moveType = RANGE_MOVE;
+   double gain;
+   long long work = 0;
 
    iterations = 0;
    while (temp > END_TEMP) {
@@ -55,45 +109,52 @@ void Simulator::run() {
        * - has consecutive number of state rejection equals MAX_REJECT
        * - has accepted new state for MAX_ACCEPT
        */
-      for (int numChange = 0; (numChange < MAX_STATE_CHANGE_PER_TEMP)
+      for (numChange = 0; (numChange < MAX_STATE_CHANGE_PER_TEMP)
             && (cReject < MAX_REJECT) && (cAccept < MAX_ACCEPT); numChange++) {
-         State newState(currentState); //deep copy
-         newState.generateNewState();
-         changeCost = newState.getCost() - currentState.getCost();
+         /*
+          * the move is evaluated without changing currentState
+          * and only applied when it is accepted
+          */
+         if (rangeLimit) {
+            work = currentState.getWork();
+            moveType = currentState.proposeMove(random,
+                  selector.select(random));
+         } else {
+            currentState.proposeMove(random);
+         }
+         gain = 0;
 
          iterations++;
 
          /*
-          * Check current state legality
+          * Check new state legality
           */
-         if (newState.isLegal()) {
+         if (currentState.isMoveLegal()) {
             /*
-             * Always accept lower cost state
+             * a higher cost is accepted with probability exp(-change / temp)
+             * so the random number is drawn first and turned into the
+             * largest change that is accepted, lower cost is always accepted
+             * the evaluation stops as soon as the change cannot be accepted
+             * rejected moves are printed in verbose printing, so their
+             * change is always evaluated in full
              */
-            if (changeCost < 0) {
+            randomNum = random.uniform_0_1();
+            threshold = -temp * log(randomNum);
+            change = currentState.evaluateMove(verbose ? HUGE_VAL : threshold);
+            if (change.cost < threshold) {
                setCurrent = true;
-               if (verbose)
-                  printState(newState, iterations, 'Y', -1);
-            } else {
-               random = uniform_0_1();
-               prob = exp(-changeCost / temp);
-               /*
-                * Accept higher cost with probability
-                */
-               if (random < prob) {
-                  setCurrent = true;
-                  if (verbose)
-                     printState(newState, iterations, 'Y', random);
-               } else {
-                  cReject++;
-                  if (verbose)
-                     printState(newState, iterations, ' ', random);
+               if (change.cost < 0) {
+                  randomNum = -1;
                }
+            } else {
+               cReject++;
+               if (verbose)
+                  printState(currentState, change, iterations, randomNum);
             }
          } else {
             cReject++;
             if (verbose)
-               printState(currentState, iterations, ' ', -1);
+               printState(currentState.getCostDetail(), iterations, ' ', -1);
          }
 
          /*
@@ -103,23 +164,58 @@ void Simulator::run() {
             setCurrent = false;
             cReject = 0;
             cAccept++;
-            currentState = newState;
+            gain = -change.cost;
+            currentState.applyMove();
+            /*
+             * recalculate the cost from scratch and report the drift
+             * of the cost tracked by the moves
+             */
+            if (CHECK_INTERVAL > 0 && ++numApplied % CHECK_INTERVAL == 0) {
+               drift = currentState.recalculateCost();
+               if (drift != 0) {
+                  cerr << "# Cost drift " << drift << " after " << iterations
+                        << " iterations" << endl;
+               }
+            }
+            if (verbose)
+               printState(currentState.getCostDetail(), iterations, 'Y',
+                     randomNum);
             /*
              * Keep track of best state so far
+             * only core positions and cost are saved
              */
-            if (newState.isLegal() && currentState.getCost()
-                  < bestState.getCost()) {
-               bestState = currentState;
+            if (currentState.getCost() < best.cost.cost) {
+               currentState.saveSnapshot(best);
                bestTemp = temp;
             }
          }
+
+         /*
+          * the move type actually made is credited with the decrease in cost
+          * and charged the work its move took
+          * a move to a latency-feasible position is not credited
+          */
+         if (rangeLimit && moveType != NO_MOVE_TYPE) {
+            selector.update(moveType, gain, currentState.getWork() - work);
+         }
       }
 
       if (!verbose && !quiet) {
-         printState(bestState, iterations);
+         printState(best, iterations);
+      }
+      /*
+       * moves of the next temperature are limited to a range
+       * where about TARGET_ACCEPT_RATE of them are accepted
+       */
+      if (rangeLimit && numChange > 0) {
+         currentState.updateRangeLimit((double) cAccept / numChange);
+         selector.decay();
       }
       temp = temp * TEMP_CHANGE_FACTOR;
    }
+
+   //network of the best state is rebuilt for printing and output
+   bestState.loadSnapshot(best);
 }
 
 void Simulator::initTable() const {
@@ -133,7 +229,7 @@ void Simulator::initTable() const {
             << "----" << setw(12) << "---------" << setw(12) << "--------" << endl;
 }
 
-void Simulator::printState(const State& state, int& iterations,
+void Simulator::printState(const Cost& cost, int& iterations,
       const char& newStateFlag, const double& randomNum) const {
 
    /*
@@ -147,7 +243,7 @@ void Simulator::printState(const State& state, int& iterations,
    /*
     * print detail cost of a state
     */
-   state.printState();
+   cost.printCost();
 
    /*
     * in verbose printing
@@ -163,9 +259,37 @@ void Simulator::printState(const State& state, int& iterations,
    cout << endl;
 }
 
+void Simulator::printState(const StateSnapshot& snapshot,
+      int& iterations) const {
+   cout << " ";
+   cout << setw(11) << iterations;
+   cout << setw(12) << setprecision(3) << temp;
+   currentState.printState(snapshot);
+   cout << endl;
+}
+
+void Simulator::printState(const State& state, const CostDelta& change,
+      int& iterations, const double& randomNum) const {
+   ostringstream strs;
+   strs << setiosflags(ios::fixed) << setprecision(6) << randomNum;
+
+   /*
+    * rejected state is commented out (for gnuplot)
+    */
+   cout << "#";
+   cout << setw(11) << iterations;
+   cout << setw(12) << setprecision(3) << temp;
+   state.printState(change);
+   cout << setw(12) << ' ' << setw(12) << strs.str();
+   cout << endl;
+}
+
 void Simulator::printSummary() const {
    cout << "# Temperature achieve: " << setprecision(6) << bestTemp << endl;
    bestState.printSummary();
+   if (rangeLimit) {
+      selector.printSummary();
+   }
 }
 
 string Simulator::printFinalCost() const {
@@ -188,6 +312,10 @@ void Simulator::printLatencyTable() {
    bestState.printLatencyTable();
 }
 
+void Simulator::printTranspositionTable() const {
+   currentState.printTranspositionTable();
+}
+
 double Simulator::getCostRatio() {
    return bestState.getCostRatio();
 }
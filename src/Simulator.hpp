@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "State.hpp"
+#include "MoveSelector.hpp"
 
 using std::stringstream;
 
@@ -18,6 +19,49 @@ class Simulator {
       int init(double alpha, double beta, double gamma, double delta, \
                double startTemp, double endTemp, double rate, int iter, \
                int reject, int accept, char* inputfile, bool verbose, bool quiet );
+      /*
+       * Initialize simulated annealing with a problem that is already read
+       * - the problem can be shared by several simulators
+       */
+      int init(double alpha, double beta, double gamma, double delta, \
+               double startTemp, double endTemp, double rate, int iter, \
+               int reject, int accept, shared_ptr<const Problem> problem, \
+               bool verbose, bool quiet);
+      /*
+       * propose only moves to positions that meet the latency constraints
+       * of the moved core, must be called after init
+       */
+      void setFeasibleMove(bool enable);
+      /*
+       * propose range-limited moves, shifts and neighbour swaps
+       * the range limit follows the acceptance rate of every temperature
+       * and the move type is selected by how much it improves the cost
+       * per unit of work, counted in adjacency entries and route steps
+       * must be called after init
+       */
+      void setRangeLimit(bool enable);
+      /*
+       * select most moved cores with probability proportional to
+       * the cost of their connections, must be called after init
+       */
+      void setHotCore(bool enable);
+      /*
+       * seed the random numbers of the run
+       * runs with the same seed and stream make the same moves
+       */
+      void setSeed(unsigned int seed, int stream = 0);
+      /*
+       * recalculate the cost from scratch every "interval" accepted moves
+       * and report any drift of the tracked cost, 0 never recalculates
+       */
+      void setCheckInterval(int interval);
+      /*
+       * keep evaluated placements in a transposition table of 2^bits
+       * entries, 0 keeps none, must be called after init
+       * false is returned when no table is kept, a table is only used
+       * when moves are evaluated with utilization
+       */
+      bool setTranspositionTable(int bits);
       /*
        * starts simulated annealing
        */
@@ -51,6 +95,10 @@ class Simulator {
        * print latency table
        */
       void printLatencyTable();
+      /*
+       * print hit rate and memory used by the transposition table
+       */
+      void printTranspositionTable() const;
 
       double getCostRatio();
 
@@ -61,22 +109,45 @@ class Simulator {
       int MAX_ACCEPT;
       double TEMP_CHANGE_FACTOR;
       double END_TEMP;
+      int CHECK_INTERVAL;
 
       //variable
       State currentState;
+      /*
+       * best state so far is kept as a snapshot during the run
+       * bestState is rebuilt from it when the run ends
+       */
+      StateSnapshot best;
       State bestState;
+      RandomGenerator random;
+      /*
+       * selection of the move type of range-limited moves
+       */
+      MoveSelector selector;
       double temp;
       double bestTemp; //temp that achieve best configuration
       bool verbose;
       bool quiet;
+      bool rangeLimit;
 
       /*
-       * print a state detail in tabular format
+       * print cost detail of a state in tabular format
        * used for verbose and normal printing
        */
-      void printState(const State& state, int& iterations, \
+      void printState(const Cost& cost, int& iterations, \
                       const char& newStateFlag = 'Y', \
                       const double& randomNum = -1) const;
+      /*
+       * print cost detail of a snapshot of a state in tabular format
+       * used for normal printing
+       */
+      void printState(const StateSnapshot& snapshot, int& iterations) const;
+      /*
+       * print a rejected state which is "change" away from "state"
+       * used for verbose printing
+       */
+      void printState(const State& state, const CostDelta& change, \
+                      int& iterations, const double& randomNum) const;
 };
 
 #endif
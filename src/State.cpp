@@ -3,6 +3,9 @@
 #include <fstream>
 #include <cstring>
 #include <iomanip>
+#include <cassert>
+#include <climits>
+#include <algorithm>
 
 #include "Defs.hpp"
 #include "State.hpp"
@@ -11,197 +14,713 @@
 using namespace std;
 
 State::State() {
-   meshRow = 0;
-   meshCol = 0;
+   lastMove.coreA = NO_CORE;
+   lastMove.coreB = NO_CORE;
+   lastMove.applied = false;
+   illegalCount = 0;
+   feasibleMove = false;
+   rangeMove = false;
+   rangeLimit = 0;
+   hotCore = false;
+   keepUtilization = true;
+   routesStale = false;
+   hash = 0;
+   adjacencyWork = 0;
 }
 
 State::~State() {
 }
 
 int State::init(double alpha, double beta, double gamma, double delta,
-      char* filename) {
+      shared_ptr<const Problem> problem) {
+   this->problem = problem;
+   const Netlist& netlist = problem->getNetlist();
+   int numCore = problem->getNumCore();
 
-   int numCore;
-
-   ifstream file(filename);
-   if (!file.is_open()) {
-      return FILE_OPEN_ERR;
+   /*
+    * Place cores at their initial positions
+    */
+   Coordinate pos;
+   core.clear();
+   for (int i = 0; i < numCore; i++) {
+      pos = problem->getInitialPosition(i);
+      core.push_back(Core(pos.x, pos.y));
    }
+   initNetwork();
 
-   file >> LINK_BANDWIDTH >> LINK_LATENCY >> meshRow >> meshCol >> numCore;
+   illegalCount = countIllegal();
+   if (!isLegal()) {
+      return ILLEGAL_STATE_ERR;
+   }
 
    /*
-    * allocate memory for bandwidth and latency
-    * initialize them to zero
+    * Calculate initial cost
     */
-   bandwidth = vector< vector<double> > (numCore, vector<double> (numCore));
-   latency = vector< vector<double> > (numCore, vector<double> (numCore));
+   cost.init(alpha, beta, gamma, delta);
+   cost.initCost(netlist, core, problem->getLinkLatency(), network);
+
+   return NO_ERR;
+}
+
+double State::getCost() const {
+   return cost.getCost();
+}
+
+double State::recalculateCost() {
+   //utilization that is not maintained by the moves cannot drift
+   if (routesStale) {
+      rebuildNetwork();
+      cost.calculateCost(network);
+   }
+   return cost.recalculateCost(problem->getNetlist(), core,
+         problem->getLinkLatency(), network);
+}
+
+const Cost& State::getCostDetail() const {
+   return cost;
+}
+
+void State::initNetwork() {
+   const Netlist& netlist = problem->getNetlist();
+   int numCore = core.size();
 
    /*
     * Initialize the network by placing cores on the network
     */
-   int x, y;
-   network.init(meshRow, meshCol);
+   network.init(problem->getMeshRow(), problem->getMeshCol(),
+         netlist.getScale());
    for (int i = 0; i < numCore; i++) {
-      if (file.good()) {
-         file >> x >> y;
-      }
-      core.push_back(Core(x, y));
       network.addCore(core[i].getPosition(), i);
    }
 
-   /*
-    * Read the connections from file
-    * Initialize the bandwidth matrix and latency matrix
-    */
-   int from, to;
-   double bw, laten;
-   while (file.good()) {
-      file >> from >> to >> bw >> laten;
-      bandwidth[from - 1][to - 1] = bw;
-      latency[from - 1][to - 1] = laten;
-   }
-
    /*
     * Initialize the connection in the network
     */
    for (int i = 0; i < numCore; i++) {
-      for (int j = 0; j < numCore; j++) {
-         if (bandwidth[i][j] != 0) { //has a connection from i to j
+      for (int k = netlist.outBegin(i); k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.bandwidth != 0) { //has a connection from i to c.peer
             network.changeConnection(core[i].getPosition(),
-                  core[j].getPosition(), ADD);
+                  core[c.peer].getPosition(), ADD);
          }
       }
    }
+}
 
-   if (!isLegal()) {
-      return ILLEGAL_STATE_ERR;
+void State::rebuildNetwork() {
+   initNetwork();
+   network.updateUtilization(problem->getNetlist(), core);
+   network.calculateUtilization();
+   routesStale = false;
+}
+
+void State::saveSnapshot(StateSnapshot& snapshot) const {
+   snapshot.position.resize(core.size());
+   for (unsigned int i = 0; i < core.size(); i++) {
+      snapshot.position[i] = core[i].getPosition();
+   }
+   cost.saveSnapshot(snapshot.cost);
+}
+
+void State::loadSnapshot(const StateSnapshot& snapshot) {
+   assert(snapshot.position.size() == core.size());
+   for (unsigned int i = 0; i < core.size(); i++) {
+      core[i].setPosition(snapshot.position[i]);
    }
+   rebuildNetwork();
 
    /*
-    * Calculate initial cost
+    * utilization of the snapshot is not up to date when the moves
+    * did not keep the routes, it is taken from the rebuilt network
     */
-   cost.init(alpha, beta, gamma, delta);
-   cost.initCost(bandwidth, latency, core, LINK_LATENCY, network);
-
-   file.close();
-
-   return NO_ERR;
-}
-
-double State::getCost() const {
-   return cost.getCost();
+   cost.loadSnapshot(snapshot.cost, core, problem->getLinkLatency(), network);
+   illegalCount = countIllegal();
+   lastMove.applied = false;
+   if (transposition) {
+      hash = calculateHash();
+   }
+   if (hotCore) {
+      initCoreCosts();
+   }
 }
 
 double State::getCostRatio() {
    return cost.getCostRatio();
 }
 
-bool State::isLegal() {
-   int hops;
-   bool legal = true;
+bool State::isLegal() const {
+   return illegalCount == 0;
+}
 
-   illegalConnection.clear();
+int State::countIllegal() const {
+   const Netlist& netlist = problem->getNetlist();
+   int count = 0;
 
    /*
     * check every connections by going through
-    * every element in latency matrix
-    * if latency != 0 then we have a connection
+    * every out list of the netlist
+    */
+   for (unsigned int i = 0; i < core.size(); i++) {
+      for (int k = netlist.outBegin(i); k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         if (!isConnectionLegal(c, core[i].getPosition(),
+               core[c.peer].getPosition())) {
+            count++;
+         }
+      }
+   }
+   return count;
+}
+
+void State::setFeasibleMove(bool enable) {
+   feasibleMove = enable;
+}
+
+void State::setRangeLimit(bool enable) {
+   rangeMove = enable;
+   rangeLimit = max(problem->getMeshRow(), problem->getMeshCol());
+}
+
+void State::updateRangeLimit(double acceptRate) {
+   /*
+    * the range limit shrinks when fewer moves are accepted than the
+    * target rate and grows when more are accepted
     */
+   rangeLimit *= 1 - TARGET_ACCEPT_RATE + acceptRate;
+   rangeLimit = min(rangeLimit, (double) max(problem->getMeshRow(),
+         problem->getMeshCol()));
+   rangeLimit = max(rangeLimit, 1.0);
+}
+
+void State::setHotCore(bool enable) {
+   hotCore = enable;
+   if (enable) {
+      coreSampler.init(core.size());
+      initCoreCosts();
+   }
+}
+
+void State::initCoreCosts() {
+   coreTerms = vector<CoreTerms> (core.size());
    for (unsigned int i = 0; i < core.size(); i++) {
-      for (unsigned int j = 0; j < core.size(); j++) {
-         if (latency[i][j] != 0) { //has a connection
-            hops = getHops(core[i].getPosition(), core[j].getPosition());
-            if (latency[i][j] < hops * LINK_LATENCY) {
-               illegalConnection.push_back(make_pair(i, j));
-               legal = false;
+      coreTerms[i] = cost.getCoreTerms(problem->getNetlist(), core, i);
+      updateCoreCost(i);
+   }
+}
+
+void State::updateCoreCost(int index) {
+   double c = cost.getCoreCost(coreTerms[index], problem->getLinkLatency());
+   //slack of an illegal connection is negative, a core never weighs less than 0
+   coreSampler.set(index, max(0LL, llround(c * FIXED_POINT_SCALE)));
+}
+
+void State::updateCoreCosts(int coreA, Coordinate posA, int coreB,
+      Coordinate posB) {
+   const Netlist& netlist = problem->getNetlist();
+   int moved[2] = { coreA, coreB };
+   Coordinate newPos[2] = { posA, posB };
+   Coordinate peerOld, peerNew;
+   int diff;
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE) {
+         continue;
+      }
+      Coordinate oldPos = core[moved[m]].getPosition();
+      for (int d = 0; d < 2; d++) {
+         int begin = (d == 0) ? netlist.outBegin(moved[m])
+               : netlist.inBegin(moved[m]);
+         int end = (d == 0) ? netlist.outEnd(moved[m])
+               : netlist.inEnd(moved[m]);
+         for (int k = begin; k < end; k++) {
+            const Connection& c = (d == 0) ? netlist.getOut(k)
+                  : netlist.getIn(k);
+            /*
+             * a connection between the moved cores is taken once,
+             * from core[coreA]
+             */
+            if (c.peer == moved[m] || (m == 1 && c.peer == coreA)) {
+               continue;
+            }
+            peerOld = core[c.peer].getPosition();
+            peerNew = (c.peer == coreA) ? posA : (c.peer == coreB) ? posB
+                  : peerOld;
+            diff = getHops(newPos[m], peerNew) - getHops(oldPos, peerOld);
+            if (diff == 0) {
+               continue;
+            }
+            //the connection counts for both of its cores
+            coreTerms[moved[m]].hops += c.fixedBandwidth * diff;
+            coreTerms[c.peer].hops += c.fixedBandwidth * diff;
+            if (c.latency != 0) {
+               coreTerms[moved[m]].slackHops += diff;
+               coreTerms[c.peer].slackHops += diff;
             }
+            updateCoreCost(c.peer);
          }
       }
+      updateCoreCost(moved[m]);
    }
-   return legal;
 }
 
-void State::generateNewState() {
+int State::selectCore(RandomGenerator& random) const {
+   /*
+    * most moves go where the cost is, the others keep
+    * every core movable
+    */
+   if (hotCore && coreSampler.getTotal() > 0
+         && random.uniform_0_1() < HOT_CORE_RATE) {
+      return coreSampler.sample(random);
+   }
+   return random.uniform_n(core.size());
+}
+
+void State::setEvaluateAll(bool enable) {
+   cost.setEvaluateAll(enable);
+}
+
+void State::setKeepUtilization(bool enable) {
+   keepUtilization = enable;
+}
+
+bool State::setTranspositionTable(int bits) {
+   /*
+    * without utilization a move is cheaper to evaluate than to look up
+    */
+   if (bits <= 0 || !cost.isUtilizationEvaluated()) {
+      transposition.reset();
+      return false;
+   }
+   transposition = shared_ptr<TranspositionTable> (new TranspositionTable());
+   transposition->init(core.size(),
+         problem->getMeshRow() * problem->getMeshCol(), bits);
+   hash = calculateHash();
+   return true;
+}
+
+uint64_t State::calculateHash() const {
+   int col = problem->getMeshCol();
+   uint64_t h = 0;
+   Coordinate pos;
+   for (unsigned int i = 0; i < core.size(); i++) {
+      pos = core[i].getPosition();
+      h ^= transposition->getKey(i, pos.y * col + pos.x);
+   }
+   return h;
+}
+
+uint64_t State::getMoveHash() const {
+   int col = problem->getMeshCol();
+   int oldNode = lastMove.oldPos.y * col + lastMove.oldPos.x;
+   int newNode = lastMove.newPos.y * col + lastMove.newPos.x;
+   //core[coreA] leaves oldPos for newPos, core[coreB] (if any) goes back
+   uint64_t h = hash ^ transposition->getKey(lastMove.coreA, oldNode)
+         ^ transposition->getKey(lastMove.coreA, newNode);
+   if (lastMove.coreB != NO_CORE) {
+      h ^= transposition->getKey(lastMove.coreB, newNode)
+            ^ transposition->getKey(lastMove.coreB, oldNode);
+   }
+   return h;
+}
+
+int State::proposeMove(RandomGenerator& random) {
+   return proposeMove(random, rangeMove ? random.uniform_n(NUM_MOVE_TYPES)
+         : RANGE_MOVE);
+}
+
+int State::proposeMove(RandomGenerator& random, int type) {
    //randomly select one core
-   int changedCore = uniform_n(core.size());
+   int changedCore = selectCore(random);
    //randomly select new position
    Coordinate newPos;
-   newPos.x = uniform_n(meshCol);
-   newPos.y = uniform_n(meshRow);
+   bool selected = feasibleMove && getFeasiblePosition(changedCore, random,
+         newPos);
+   if (selected) {
+      type = NO_MOVE_TYPE;
+   } else if (rangeMove) {
+      /*
+       * shifts and neighbour swaps fall back to a range-limited move
+       * when the core has no such neighbour
+       */
+      if (type != RANGE_MOVE) {
+         selected = getNeighbourPosition(changedCore, type == NEIGHBOUR_SWAP,
+               random, newPos);
+      }
+      if (!selected) {
+         newPos = getRangePosition(changedCore, random);
+         type = RANGE_MOVE;
+      }
+   } else {
+      newPos = getOtherPosition(changedCore, random);
+      type = RANGE_MOVE;
+   }
 
+   lastMove.coreA = changedCore;
+   lastMove.oldPos = core[changedCore].getPosition();
+   lastMove.newPos = newPos;
+   lastMove.applied = false;
    /*
-    * if the new position is not empty
+    * if the new position is not empty the two cores are swapped
+    * otherwise the core is moved
     */
-   if (network.hasCore(newPos)) {
-      /*
-       * swap two cores
-       */
-      Coordinate oldPos = core[changedCore].getPosition();
-      int swapCore = network.getCoreIndex(newPos);
-
-      //remove old cost (compaction, slack, proximity)
-      cost.updateCost(bandwidth, latency, LINK_LATENCY, core, REMOVE,
-            changedCore, swapCore);
-      //remove all connections from the changed core 
-      network.changeAllConnections(bandwidth, core, changedCore, REMOVE);
-      //remove all connections from the old position of the swap core
-      network.changeAllConnections(bandwidth, core, swapCore, REMOVE);
-      //add the overlap
-      if (bandwidth[changedCore][swapCore] != 0) {
-         network.changeConnection(core[changedCore].getPosition(),
-               core[swapCore].getPosition(), ADD);
+   lastMove.coreB = network.getCoreIndex(newPos);
+   return type;
+}
+
+Coordinate State::getOtherPosition(int index, RandomGenerator& random) const {
+   const Bitboard& occupied = network.getOccupancy();
+   int col = problem->getMeshCol();
+   Coordinate pos = core[index].getPosition();
+   int nodeId = pos.y * col + pos.x;
+   int numNode = occupied.size();
+   //a core alone on a single node cannot go anywhere
+   if (numNode <= 1) {
+      return pos;
+   }
+
+   /*
+    * the first numEmpty numbers select an empty position,
+    * the others select a position of another core,
+    * the position of core[index] is skipped
+    */
+   int numEmpty = numNode - occupied.count();
+   int r = random.uniform_n(numNode - 1);
+   if (r < numEmpty) {
+      nodeId = occupied.selectZero(r);
+   } else {
+      r -= numEmpty;
+      nodeId = occupied.select(r < occupied.rank(nodeId) ? r : r + 1);
+   }
+   pos.x = nodeId % col;
+   pos.y = nodeId / col;
+   return pos;
+}
+
+Coordinate State::getRangePosition(int index, RandomGenerator& random) const {
+   int row = problem->getMeshRow();
+   int col = problem->getMeshCol();
+   int limit = (int) rangeLimit;
+   Coordinate pos = core[index].getPosition();
+
+   /*
+    * the window is clipped to the mesh, its cells are numbered
+    * row by row and the cell of core[index] is skipped
+    */
+   int xLo = max(0, pos.x - limit);
+   int xHi = min(col - 1, pos.x + limit);
+   int yLo = max(0, pos.y - limit);
+   int yHi = min(row - 1, pos.y + limit);
+   int width = xHi - xLo + 1;
+   int numCell = width * (yHi - yLo + 1) - 1;
+   if (numCell <= 0) {
+      return pos;
+   }
+   int own = (pos.y - yLo) * width + pos.x - xLo;
+   int r = random.uniform_n(numCell);
+   if (r >= own) {
+      r++;
+   }
+   pos.x = xLo + r % width;
+   pos.y = yLo + r / width;
+   return pos;
+}
+
+bool State::getNeighbourPosition(int index, bool occupied,
+      RandomGenerator& random, Coordinate& newPos) const {
+   static const int dx[4] = { 0, 0, -1, 1 };
+   static const int dy[4] = { -1, 1, 0, 0 };
+   const Bitboard& occupancy = network.getOccupancy();
+   int row = problem->getMeshRow();
+   int col = problem->getMeshCol();
+   Coordinate pos = core[index].getPosition();
+   Coordinate candidate[4];
+   int numCandidate = 0;
+
+   for (int d = 0; d < 4; d++) {
+      Coordinate p;
+      p.x = pos.x + dx[d];
+      p.y = pos.y + dy[d];
+      if (p.x >= 0 && p.x < col && p.y >= 0 && p.y < row
+            && occupancy.test(p.y * col + p.x) == occupied) {
+         candidate[numCandidate++] = p;
       }
-      if (bandwidth[swapCore][changedCore] != 0) {
-         network.changeConnection(core[swapCore].getPosition(),
-               core[changedCore].getPosition(), ADD);
+   }
+   if (numCandidate == 0) {
+      return false;
+   }
+   newPos = candidate[random.uniform_n(numCandidate)];
+   return true;
+}
+
+bool State::getFeasiblePosition(int index, RandomGenerator& random,
+      Coordinate& newPos) const {
+   const Netlist& netlist = problem->getNetlist();
+   int row = problem->getMeshRow();
+   int col = problem->getMeshCol();
+   bool constrained = false;
+   Coordinate p;
+
+   /*
+    * the hop limit h of a connection to a core at p is the diamond
+    * |x - p.x| + |y - p.y| <= h, which is the square |u - pu| <= h and
+    * |v - pv| <= h with u = x + y and v = x - y
+    * so the intersection of the diamonds is a rectangle in (u, v)
+    */
+   int uLo = 0;
+   int uHi = row + col - 2;
+   int vLo = 1 - row;
+   int vHi = col - 1;
+   for (int m = 0; m < 2; m++) {
+      int begin = (m == 0) ? netlist.outBegin(index) : netlist.inBegin(index);
+      int end = (m == 0) ? netlist.outEnd(index) : netlist.inEnd(index);
+      for (int k = begin; k < end; k++) {
+         const Connection& c = (m == 0) ? netlist.getOut(k) : netlist.getIn(k);
+         if (c.peer == index || c.maxHops == INT_MAX) {
+            continue;
+         }
+         p = core[c.peer].getPosition();
+         uLo = max(uLo, p.x + p.y - c.maxHops);
+         uHi = min(uHi, p.x + p.y + c.maxHops);
+         vLo = max(vLo, p.x - p.y - c.maxHops);
+         vHi = min(vHi, p.x - p.y + c.maxHops);
+         constrained = true;
       }
+   }
+   if (!constrained || uLo > uHi || vLo > vHi) {
+      return false;
+   }
 
-      //place core on new pos
-      core[swapCore].setPosition(oldPos);
-      network.addCore(oldPos, swapCore);
-      core[changedCore].setPosition(newPos);
-      network.addCore(newPos, changedCore);
-
-      //add all connections of changedCore
-      network.changeAllConnections(bandwidth, core, changedCore, ADD);
-      //add all connections of swap core
-      network.changeAllConnections(bandwidth, core, swapCore, ADD);
-      //remove overlap
-      if (bandwidth[changedCore][swapCore] != 0) {
-         network.changeConnection(core[changedCore].getPosition(),
-               core[swapCore].getPosition(), REMOVE);
+   /*
+    * the cells of column x inside the rectangle are
+    * max(0, uLo - x, x - vHi) <= y <= min(row - 1, uHi - x, x - vLo)
+    * a cell is selected uniformly by counting the cells of every column
+    * the current cell of the core is left out
+    */
+   p = core[index].getPosition();
+   bool inside = p.x + p.y >= uLo && p.x + p.y <= uHi && p.x - p.y >= vLo
+         && p.x - p.y <= vHi;
+   int numCell = inside ? -1 : 0;
+   for (int x = 0; x < col; x++) {
+      numCell += max(0, min(min(row - 1, uHi - x), x - vLo)
+            - max(max(0, uLo - x), x - vHi) + 1);
+   }
+   if (numCell <= 0) {
+      return false;
+   }
+   int r = random.uniform_n(numCell);
+   for (int x = 0; x < col; x++) {
+      int yLo = max(max(0, uLo - x), x - vHi);
+      int yHi = min(min(row - 1, uHi - x), x - vLo);
+      if (yLo > yHi) {
+         continue;
       }
-      if (bandwidth[swapCore][changedCore] != 0) {
-         network.changeConnection(core[swapCore].getPosition(),
-               core[changedCore].getPosition(), REMOVE);
+      int skip = (inside && x == p.x) ? 1 : 0;
+      if (r <= yHi - yLo - skip) {
+         newPos.x = x;
+         newPos.y = yLo + r;
+         if (skip && newPos.y >= p.y) {
+            newPos.y++;
+         }
+         return true;
+      }
+      r -= yHi - yLo + 1 - skip;
+   }
+   return false;
+}
+
+CostDelta State::evaluateMove(double threshold) const {
+   const Netlist& netlist = problem->getNetlist();
+   const double LINK_LATENCY = problem->getLinkLatency();
+   CostDelta change;
+   PlacementCost placement;
+   uint64_t moveHash = 0;
+
+   /*
+    * a placement evaluated before is not evaluated again
+    */
+   if (transposition) {
+      moveHash = getMoveHash();
+      if (transposition->find(moveHash, placement)) {
+         return cost.evaluatePlacement(placement, LINK_LATENCY);
       }
-      //calculate new cost (compaction, slack, proximity)
-      cost.updateCost(bandwidth, latency, LINK_LATENCY, core, ADD, changedCore, swapCore);
-      //calculate new cost
-      cost.calculateCost(bandwidth, core, network);
+   }
 
+   adjacencyWork += getMoveDegree(lastMove.coreA, lastMove.coreB);
+   PlacementCost* p = transposition ? &placement : NULL;
+   if (lastMove.coreB != NO_CORE) {
+      change = cost.evaluateSwap(netlist, LINK_LATENCY, core, network,
+            lastMove.coreA, lastMove.coreB, threshold, p);
    } else {
+      change = cost.evaluateMove(netlist, LINK_LATENCY, core, network,
+            lastMove.coreA, lastMove.newPos, threshold, p);
+   }
+   //only a complete evaluation is kept
+   if (transposition && !change.bound) {
+      transposition->insert(moveHash, placement);
+   }
+   return change;
+}
+
+bool State::isMoveLegal() const {
+   int coreA = lastMove.coreA;
+   int coreB = lastMove.coreB;
+   int after = countIllegal(coreA, lastMove.newPos, coreB, lastMove.oldPos);
+   /*
+    * only connections from/to the moved cores can change
+    * in a legal state they must all be legal after the move
+    */
+   if (illegalCount == 0) {
+      return after == 0;
+   }
+   Coordinate posB = (coreB != NO_CORE) ? core[coreB].getPosition()
+         : lastMove.oldPos;
+   return illegalCount - countIllegal(coreA, lastMove.oldPos, coreB, posB)
+         + after == 0;
+}
+
+int State::countIllegal(int coreA, Coordinate posA, int coreB,
+      Coordinate posB) const {
+   const Netlist& netlist = problem->getNetlist();
+   int moved[2] = { coreA, coreB };
+   Coordinate movedPos[2] = { posA, posB };
+   Coordinate pos;
+   int count = 0;
+
+   /*
+    * the connections between coreA and coreB are checked
+    * from the out lists
+    */
+   for (int m = 0; m < 2; m++) {
+      if (moved[m] == NO_CORE) {
+         continue;
+      }
+      for (int k = netlist.outBegin(moved[m]); k < netlist.outEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.peer == coreA) {
+            pos = movedPos[0];
+         } else if (c.peer == coreB) {
+            pos = movedPos[1];
+         } else {
+            pos = core[c.peer].getPosition();
+         }
+         if (!isConnectionLegal(c, movedPos[m], pos)) {
+            count++;
+         }
+      }
+      for (int k = netlist.inBegin(moved[m]); k < netlist.inEnd(moved[m]);
+            k++) {
+         const Connection& c = netlist.getIn(k);
+         if (c.peer == coreA || c.peer == coreB) {
+            continue;
+         }
+         if (!isConnectionLegal(c, core[c.peer].getPosition(), movedPos[m])) {
+            count++;
+         }
+      }
+   }
+   return count;
+}
+
+bool State::isConnectionLegal(const Connection& c, Coordinate fromPos,
+      Coordinate toPos) const {
+   return getHops(fromPos, toPos) <= c.maxHops;
+}
+
+void State::applyMove() {
+   const Netlist& netlist = problem->getNetlist();
+   const double LINK_LATENCY = problem->getLinkLatency();
+   int changedCore = lastMove.coreA;
+   int swapCore = lastMove.coreB;
+
+   assert(!lastMove.applied);
+   lastMove.applied = true;
+
+   //only connections from/to the moved cores can change legality
+   Coordinate posB = (swapCore != NO_CORE) ? core[swapCore].getPosition()
+         : lastMove.oldPos;
+   illegalCount += countIllegal(changedCore, lastMove.newPos, swapCore,
+         lastMove.oldPos) - countIllegal(changedCore, lastMove.oldPos,
+         swapCore, posB);
+
+   /*
+    * core[changedCore] goes to the new position
+    * core[swapCore] (if any) takes its old position
+    */
+   adjacencyWork += getMoveDegree(changedCore, swapCore);
+   //update cost (compaction, slack, proximity) before the cores are moved
+   cost.updateCost(netlist, LINK_LATENCY, core, changedCore, lastMove.newPos,
+         swapCore, lastMove.oldPos);
+   placeCores(changedCore, lastMove.newPos, swapCore, lastMove.oldPos);
+   //calculate new cost
+   cost.calculateCost(network);
+}
+
+long long State::getWork() const {
+   return adjacencyWork + network.getRouteSteps();
+}
+
+int State::getMoveDegree(int coreA, int coreB) const {
+   const Netlist& netlist = problem->getNetlist();
+   int degree = netlist.outEnd(coreA) - netlist.outBegin(coreA)
+         + netlist.inEnd(coreA) - netlist.inBegin(coreA);
+   if (coreB != NO_CORE) {
+      degree += netlist.outEnd(coreB) - netlist.outBegin(coreB)
+            + netlist.inEnd(coreB) - netlist.inBegin(coreB);
+   }
+   return degree;
+}
+
+void State::placeCores(int coreA, Coordinate posA, int coreB,
+      Coordinate posB) {
+   /*
+    * without utilization the routes are not re-traced,
+    * only the cores are placed on the network
+    */
+   bool traceRoutes = keepUtilization || cost.isUtilizationEvaluated();
+   if (traceRoutes) {
+      if (routesStale) {
+         rebuildNetwork();
+      }
       /*
-       * new position is empty then
-       * the core is moved
+       * the move is evaluated as a trial move of the network
+       * unless it has just been evaluated by evaluateMove
        */
-      //remove old cost (compaction, slack, proximity)
-      cost.updateCost(bandwidth, latency, LINK_LATENCY, core, REMOVE,
-            changedCore);
-      //remove all connections from the old position
-      network.changeAllConnections(bandwidth, core, changedCore, REMOVE);
-      //move core from old pos
-      network.removeCore(core[changedCore].getPosition());
-      //place core on new pos
-      core[changedCore].setPosition(newPos);
-      network.addCore(core[changedCore].getPosition(), changedCore);
-      //add all connections 
-      network.changeAllConnections(bandwidth, core, changedCore, ADD);
-      //calculate new cost (compaction, slack, proximity)
-      cost.updateCost(bandwidth, latency, LINK_LATENCY, core, ADD, changedCore);
-      //calculate new cost
-      cost.calculateCost(bandwidth, core, network);
+      if (!network.hasTrial(coreA, posA, coreB, posB)) {
+         network.evaluateUtilization(problem->getNetlist(), core, coreA,
+               posA, coreB, posB);
+      }
+   } else {
+      network.removeCore(core[coreA].getPosition());
+      if (coreB != NO_CORE) {
+         network.removeCore(core[coreB].getPosition());
+      }
+      network.addCore(posA, coreA);
+      if (coreB != NO_CORE) {
+         network.addCore(posB, coreB);
+      }
+      routesStale = true;
+   }
+   if (transposition) {
+      int col = problem->getMeshCol();
+      Coordinate pos = core[coreA].getPosition();
+      hash ^= transposition->getKey(coreA, pos.y * col + pos.x)
+            ^ transposition->getKey(coreA, posA.y * col + posA.x);
+      if (coreB != NO_CORE) {
+         pos = core[coreB].getPosition();
+         hash ^= transposition->getKey(coreB, pos.y * col + pos.x)
+               ^ transposition->getKey(coreB, posB.y * col + posB.x);
+      }
+   }
+   if (hotCore) {
+      updateCoreCosts(coreA, posA, coreB, posB);
+   }
+   core[coreA].setPosition(posA);
+   if (coreB != NO_CORE) {
+      core[coreB].setPosition(posB);
+   }
+   //turn counts, links and psudonodes are changed in a single pass
+   if (traceRoutes) {
+      network.commitMove();
    }
 }
 
@@ -209,6 +728,14 @@ void State::printState() const {
    cost.printCost();
 }
 
+void State::printState(const CostDelta& change) const {
+   cost.printCost(change);
+}
+
+void State::printState(const StateSnapshot& snapshot) const {
+   cost.printCost(snapshot.cost, problem->getLinkLatency());
+}
+
 void State::printSummary() const {
    cost.printSummary();
    network.printMaxBandwidthLink();
@@ -220,12 +747,14 @@ string State::printQuiet() const {
 }
 
 void State::generateOutput(char *fileName) {
+   const Netlist& netlist = problem->getNetlist();
    ofstream file(fileName);
 
    int numCore = core.size();
 
-   file << LINK_BANDWIDTH << " " << LINK_LATENCY << endl << meshRow << " "
-         << meshCol << endl << numCore << endl;
+   file << problem->getLinkBandwidth() << " " << problem->getLinkLatency()
+         << endl << problem->getMeshRow() << " " << problem->getMeshCol()
+         << endl << numCore << endl;
 
    /*
     * print core position
@@ -239,11 +768,11 @@ void State::generateOutput(char *fileName) {
     * print list of connections
     */
    for (int i = 0; i < numCore; i++) {
-      for (int j = 0; j < numCore; j++) {
-         if (bandwidth[i][j] != 0) {
-            file << i + 1 << " " << j + 1 << " " << bandwidth[i][j] << " "
-                  << latency[i][j] << endl;
-         }
+      for (int k = netlist.outBegin(i); k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         //connections with only a latency constraint are kept as well
+         file << i + 1 << " " << c.peer + 1 << " " << c.bandwidth << " "
+               << c.latency << endl;
       }
    }
 
@@ -251,17 +780,27 @@ void State::generateOutput(char *fileName) {
 }
 
 void State::printIllegalConnection() {
-   vector<pair<unsigned int, unsigned int> >::iterator p;
+   const Netlist& netlist = problem->getNetlist();
    cout << "# Contain illegal connection" << endl;
-   for (p = illegalConnection.begin(); p != illegalConnection.end(); p++) {
-      cout << "# (" << (*p).first + 1 << "," << (*p).second + 1 << ") ";
-      cout << bandwidth[(*p).first][(*p).second] << " "
-            << latency[(*p).first][(*p).second];
-      cout << endl;
+   /*
+    * the list is built only when it is printed
+    */
+   for (unsigned int i = 0; i < core.size(); i++) {
+      for (int k = netlist.outBegin(i); k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         if (!isConnectionLegal(c, core[i].getPosition(),
+               core[c.peer].getPosition())) {
+            cout << "# (" << i + 1 << "," << c.peer + 1 << ") ";
+            cout << c.bandwidth << " " << c.latency;
+            cout << endl;
+         }
+      }
    }
 }
 
 void State::printLatencyTable() {
+   const Netlist& netlist = problem->getNetlist();
+   const double LINK_LATENCY = problem->getLinkLatency();
    int numCore = core.size();
    cout << "#\n# Latency Table" << endl;
    cout << "# " << setfill('=') << setw(36) << "=" << setfill(' ') << endl;
@@ -270,13 +809,20 @@ void State::printLatencyTable() {
    cout << "# " << setw(10) << "----------" << setw(12) << "----------" << setw(10)
         << "------" << endl;
    for (int i = 0; i < numCore; i++) {
-      for (int j = 0; j < numCore; j++) {
-         if (latency[i][j] != 0) {
-            cout << "# " << setw(5) << i + 1 << "," << setw(4) << left << j + 1
-                 << setw(12) << right << latency[i][j]
-                 << setw(10) << getHops(core[i].getPosition(), core[j].getPosition()) * LINK_LATENCY
+      for (int k = netlist.outBegin(i); k < netlist.outEnd(i); k++) {
+         const Connection& c = netlist.getOut(k);
+         if (c.latency != 0) {
+            cout << "# " << setw(5) << i + 1 << "," << setw(4) << left << c.peer + 1
+                 << setw(12) << right << c.latency
+                 << setw(10) << getHops(core[i].getPosition(), core[c.peer].getPosition()) * LINK_LATENCY
                  << endl;
          }
       }
    }
 }
+
+void State::printTranspositionTable() const {
+   if (transposition) {
+      transposition->printStats();
+   }
+}
@@ -5,15 +5,46 @@
 #include <vector>
 #include <cmath>
 #include <string>
+#include <memory>
 
 #include "Defs.hpp"
 #include "Core.hpp"
 #include "Network.hpp"
 #include "Cost.hpp"
+#include "Netlist.hpp"
+#include "Problem.hpp"
+#include "RandomGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "CoreSampler.hpp"
 
 using std::vector;
 using std::pair;
 using std::string;
+using std::shared_ptr;
+
+/*
+ * Record of a proposed move
+ * - coreB is NO_CORE when core[coreA] is moved to an empty position
+ *   otherwise core[coreA] and core[coreB] are swapped
+ * - applied tells whether the move has been applied to the state
+ */
+struct MoveRecord {
+   int coreA;
+   int coreB;
+   Coordinate oldPos;
+   Coordinate newPos;
+   bool applied;
+};
+
+/*
+ * Snapshot of a state, enough to rebuild it
+ * - position of every core
+ * - scalar terms of the cost of the state
+ */
+struct StateSnapshot {
+   vector<Coordinate> position;
+   CostSnapshot cost;
+};
 
 class State {
    public:
@@ -23,26 +54,140 @@ class State {
 
       /*
        * Initialize a state
+       * - cores are placed at the initial positions of "problem"
+       * - the problem is shared, a copy of the state refers to the same problem
+       */
+      int init(double alpha, double beta, double gamma, double delta, \
+               shared_ptr<const Problem> problem);
+      /*
+       * randomly select a move using "random" and record it in lastMove
+       * the state is not changed until applyMove is called
+       * the type of the proposed move is returned
+       */
+      int proposeMove(RandomGenerator& random);
+      /*
+       * same as proposeMove but "type" selects the kind of move
+       * it is only used when range-limited moves are enabled
+       * the returned type differs from "type" when the move falls back
+       * to a range-limited move or to a latency-feasible position
+       */
+      int proposeMove(RandomGenerator& random, int type);
+      /*
+       * select how proposeMove picks the new position
+       * - enable = false, any position of the mesh
+       * - enable = true, a position where the moved core meets the latency
+       *   constraints of its connections, any position when there is none
+       */
+      void setFeasibleMove(bool enable);
+      /*
+       * select the moves proposeMove makes
+       * - enable = false, moves to any position of the mesh
+       * - enable = true, range-limited moves, shifts and neighbour swaps
+       *   proposeMove selects each of them with equal probability
+       *   the range limit starts at the size of the mesh
+       */
+      void setRangeLimit(bool enable);
+      /*
+       * shrink or grow the range limit after a temperature
+       * whose moves were accepted at "acceptRate"
+       * the limit stays between one hop and the size of the mesh
+       */
+      void updateRangeLimit(double acceptRate);
+      /*
+       * select how proposeMove picks the moved core
+       * - enable = false, every core is equally likely
+       * - enable = true, HOT_CORE_RATE of the moves pick a core with
+       *   probability proportional to the cost of its connections,
+       *   the others pick any core
+       */
+      void setHotCore(bool enable);
+      /*
+       * evaluate every cost term of a move, even the ones with zero weight
+       * so that the cost of every term of a rejected move can be printed
+       */
+      void setEvaluateAll(bool enable);
+      /*
+       * keep the routes of the network and utilization up to date after
+       * every move even when utilization is not evaluated, so that the
+       * utilization of the state can be printed during the run
+       * - enable = false, moves only place the cores on the network when
+       *   utilization is not evaluated, the routes are rebuilt when they
+       *   are needed again
+       */
+      void setKeepUtilization(bool enable);
+      /*
+       * keep the cost terms of evaluated placements in a transposition
+       * table of 2^bits entries, a placement found in the table is not
+       * evaluated again
+       * - bits = 0 removes the table
+       * - the table is only used when moves are evaluated with utilization
+       * - true is returned when a table is kept
+       */
+      bool setTranspositionTable(int bits);
+      /*
+       * evaluate change in cost of the proposed move
+       * without changing the state
+       * - the evaluation may stop early when the change in cost cannot be
+       *   below "threshold", cost of the change is then only a lower bound
        */
-      int init(double alpha, double beta, double gamma, double theta, \
-               char* filename);
+      CostDelta evaluateMove(double threshold = HUGE_VAL) const;
       /*
-       * generate new state from current state
+       * check that the state is legal after the proposed move
+       * without changing the state
+       * - only connections of the moved cores are checked
        */
-      void generateNewState();
+      bool isMoveLegal() const;
+      /*
+       * apply the proposed move in place
+       */
+      void applyMove();
+      /*
+       * work done by evaluating and applying moves so far
+       * adjacency entries of the moved cores plus route steps traced,
+       * it depends only on the moves, not on timing
+       */
+      long long getWork() const;
       /*
        * check if the state is legal
        * - using latency constraint
+       * - the number of illegal connections is maintained by every move
        */
-      bool isLegal();
+      bool isLegal() const;
       /*
        * get current cost of a state
        */
       double getCost() const;
+      /*
+       * recalculate the cost of the state from scratch
+       * the largest drift of a cost term is returned
+       */
+      double recalculateCost();
+      /*
+       * get cost details of a state
+       */
+      const Cost& getCostDetail() const;
+      /*
+       * save core positions and cost of the state into "snapshot"
+       */
+      void saveSnapshot(StateSnapshot& snapshot) const;
+      /*
+       * rebuild the state from a snapshot of a state of the same problem
+       * - the network is rebuilt from the core positions
+       * - cost is taken from the snapshot
+       */
+      void loadSnapshot(const StateSnapshot& snapshot);
       /*
        * print cost details of a state
        */
       void printState() const;
+      /*
+       * print cost details of a state after applying "change"
+       */
+      void printState(const CostDelta& change) const;
+      /*
+       * print cost details of a snapshot of a state of the same problem
+       */
+      void printState(const StateSnapshot& snapshot) const;
       /*
        * print state summary
        * - cost
@@ -69,28 +214,158 @@ class State {
        * print latency table
        */
       void printLatencyTable();
+      /*
+       * print hit rate and memory used by the transposition table (if any)
+       */
+      void printTranspositionTable() const;
 
       double getCostRatio();
 
    private:
-      double LINK_BANDWIDTH;
-      double LINK_LATENCY;
-      
       //variable
-      vector< vector<double> > bandwidth;
-      vector< vector<double> > latency;
-      int meshRow;
-      int meshCol;
+      shared_ptr<const Problem> problem;
 
       vector<Core> core; 
       Network network;
       Cost cost;
 
       /*
-       * List of illegal conneciton pair of "from" and "to"
+       * keep the routes of the network after every move, see
+       * setKeepUtilization, routesStale tells that a move was applied
+       * without them
+       */
+      bool keepUtilization;
+      bool routesStale;
+      /*
+       * number of connections that do not meet their latency constraint
+       */
+      int illegalCount;
+      /*
+       * propose only positions that meet the latency constraints
+       */
+      bool feasibleMove;
+      /*
+       * propose range-limited moves, the largest distance in x and y
+       * of a range-limited move is rangeLimit rounded down
+       */
+      bool rangeMove;
+      double rangeLimit;
+      /*
+       * select moved cores by the cost of their connections
+       * the sampler keeps the cost of every core in 1 / FIXED_POINT_SCALE
+       * coreTerms are the cost terms of every core, updated by every move
+       */
+      bool hotCore;
+      CoreSampler coreSampler;
+      vector<CoreTerms> coreTerms;
+
+      /*
+       * proposed move or the last applied move
        */
-      vector< pair <unsigned int,unsigned int> > illegalConnection;
+      MoveRecord lastMove;
+      /*
+       * adjacency entries of the moved cores visited by evaluateMove
+       * and applyMove
+       */
+      mutable long long adjacencyWork;
+
+      /*
+       * table of evaluated placements, NULL when it is not used
+       * hash is the Zobrist hash of the current placement
+       */
+      shared_ptr<TranspositionTable> transposition;
+      uint64_t hash;
 
+      /*
+       * count illegal connections of the whole state
+       */
+      int countIllegal() const;
+      /*
+       * count illegal connections from/to core[coreA] and core[coreB] (if any)
+       * when they are placed at "posA" and "posB"
+       */
+      int countIllegal(int coreA, Coordinate posA, int coreB, Coordinate posB) const;
+      /*
+       * randomly select a position where core[index] meets the latency
+       * constraints of all its connections, the other cores staying in place
+       * the current position of core[index] is never selected
+       * false is returned when core[index] has no latency constraint
+       * or when no other position meets them
+       */
+      bool getFeasiblePosition(int index, RandomGenerator& random, Coordinate& newPos) const;
+      /*
+       * randomly select any position other than the position of core[index]
+       * empty positions and positions of other cores are sampled from
+       * the occupancy of the network, every position is equally likely
+       */
+      Coordinate getOtherPosition(int index, RandomGenerator& random) const;
+      /*
+       * number of adjacency entries of core[coreA] and core[coreB] (if any)
+       */
+      int getMoveDegree(int coreA, int coreB) const;
+      /*
+       * randomly select the core to move
+       */
+      int selectCore(RandomGenerator& random) const;
+      /*
+       * calculate the cost terms of every core from scratch
+       */
+      void initCoreCosts();
+      /*
+       * set cost of core[index] in the core sampler from its terms
+       */
+      void updateCoreCost(int index);
+      /*
+       * update cost terms of core[coreA], core[coreB] (if any) and the
+       * cores connected to them when core[coreA] is moved to "posA" and
+       * core[coreB] to "posB", only the change of every connection of
+       * the moved cores is added. This must be called before the cores
+       * are moved
+       */
+      void updateCoreCosts(int coreA, Coordinate posA, int coreB,
+            Coordinate posB);
+      /*
+       * randomly select a position other than the position of core[index]
+       * at most rangeLimit away from it in x and y
+       */
+      Coordinate getRangePosition(int index, RandomGenerator& random) const;
+      /*
+       * randomly select a neighbouring position of core[index] that is
+       * empty (occupied = false) or has a core (occupied = true)
+       * false is returned when there is no such position
+       */
+      bool getNeighbourPosition(int index, bool occupied, RandomGenerator& random,
+            Coordinate& newPos) const;
+      /*
+       * check latency constraint of connection "c"
+       * when its source is at "fromPos" and its destination at "toPos"
+       */
+      bool isConnectionLegal(const Connection& c, Coordinate fromPos, Coordinate toPos) const;
+
+      /*
+       * Zobrist hash of the current placement
+       */
+      uint64_t calculateHash() const;
+      /*
+       * Zobrist hash of the placement after the proposed move
+       */
+      uint64_t getMoveHash() const;
+
+      /*
+       * initialize the network with the cores at their positions
+       * and the connections between them
+       */
+      void initNetwork();
+      /*
+       * rebuild the network and its utilization from the core positions
+       */
+      void rebuildNetwork();
+      /*
+       * place core[coreA] at "posA" and core[coreB] (if any) at "posB"
+       * - core positions, the network, the hash and the core costs are
+       *   updated, the cost of the state is not
+       */
+      void placeCores(int coreA, Coordinate posA, int coreB, Coordinate posB);
 };
 
 #endif
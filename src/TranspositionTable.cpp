@@ -0,0 +1,64 @@
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+
+#include "TranspositionTable.hpp"
+#include "RandomGenerator.hpp"
+
+using namespace std;
+
+TranspositionTable::TranspositionTable() {
+   numNode = 0;
+   mask = 0;
+   lookups = 0;
+   hits = 0;
+}
+
+TranspositionTable::~TranspositionTable() {
+}
+
+void TranspositionTable::init(int numCore, int numNode, int bits) {
+   assert(bits >= 0 && bits <= MAX_TRANSPOSITION_BITS);
+   this->numNode = numNode;
+   RandomGenerator random(ZOBRIST_SEED);
+   keys = vector<uint64_t> (numCore * numNode);
+   for (unsigned int i = 0; i < keys.size(); i++) {
+      keys[i] = random.uniform_64();
+   }
+
+   Entry empty;
+   empty.hash = 0;
+   empty.used = false;
+   entries = vector<Entry> ((size_t) 1 << bits, empty);
+   mask = ((uint64_t) 1 << bits) - 1;
+   lookups = 0;
+   hits = 0;
+}
+
+bool TranspositionTable::find(uint64_t hash, PlacementCost& placement) {
+   const Entry& e = entries[hash & mask];
+   lookups++;
+   if (!e.used || e.hash != hash) {
+      return false;
+   }
+   hits++;
+   placement = e.placement;
+   return true;
+}
+
+void TranspositionTable::insert(uint64_t hash,
+      const PlacementCost& placement) {
+   Entry& e = entries[hash & mask];
+   e.hash = hash;
+   e.used = true;
+   e.placement = placement;
+}
+
+void TranspositionTable::printStats() const {
+   double rate = (lookups > 0) ? 100.0 * hits / lookups : 0;
+   size_t bytes = keys.size() * sizeof(uint64_t)
+         + entries.size() * sizeof(Entry);
+   cout << "# Transposition table: " << hits << " hits in " << lookups
+         << " lookups (" << setprecision(3) << rate << "%), " << bytes
+         << " bytes" << endl;
+}
@@ -0,0 +1,75 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <stdint.h>
+#include <vector>
+
+#include "Defs.hpp"
+#include "Cost.hpp"
+
+//seed of the keys, every table of a problem uses the same keys
+#define ZOBRIST_SEED 0x9e3779b97f4a7c15ULL
+//largest table, 2^MAX_TRANSPOSITION_BITS entries
+#define MAX_TRANSPOSITION_BITS 26
+
+using std::vector;
+
+/*
+ * Table of the cost terms of evaluated placements
+ * A placement is identified by its Zobrist hash, the xor of the keys of
+ * (core, node) for every core placed on a node. Moving a core changes the
+ * hash by the keys of its old and new nodes only.
+ * The table is direct-mapped and lossy, a placement replaces whatever was
+ * kept in its slot. Entries hold the whole hash, so a lookup only finds
+ * the placement that was stored.
+ */
+class TranspositionTable {
+   public:
+      TranspositionTable();
+      ~TranspositionTable();
+
+      /*
+       * Initialize keys for "numCore" cores on "numNode" nodes
+       * and an empty table of 2^bits entries
+       * bits is at most MAX_TRANSPOSITION_BITS
+       */
+      void init(int numCore, int numNode, int bits);
+      /*
+       * get key of core[index] placed on node "nodeId"
+       */
+      uint64_t getKey(int index, int nodeId) const;
+      /*
+       * find cost terms of the placement with hash "hash"
+       * false is returned when the placement is not kept
+       */
+      bool find(uint64_t hash, PlacementCost& placement);
+      /*
+       * keep cost terms of the placement with hash "hash"
+       */
+      void insert(uint64_t hash, const PlacementCost& placement);
+      /*
+       * print number of lookups, hit rate and memory used
+       */
+      void printStats() const;
+
+   private:
+      struct Entry {
+         uint64_t hash;
+         bool used;
+         PlacementCost placement;
+      };
+
+      int numNode;
+      uint64_t mask;
+      vector<uint64_t> keys;
+      vector<Entry> entries;
+
+      long long lookups;
+      long long hits;
+};
+
+inline uint64_t TranspositionTable::getKey(int index, int nodeId) const {
+   return keys[index * numNode + nodeId];
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <algorithm>
 
 #include "Utilization.hpp"
 
@@ -8,59 +9,123 @@ using namespace std;
 
 Utilization::Utilization() {
    size = 0;
+   scale = FIXED_POINT_SCALE;
+   total = 0;
 }
 
 Utilization::~Utilization() {
 }
 
-void Utilization::init(int row, int col) {
+void Utilization::init(int row, int col, long long scale) {
    size = row * col;
-   utilization = vector< vector<Link> > (size, vector<Link> (MAX_DIRECTION));
+   this->scale = scale;
+   connection = vector<int> (size * MAX_DIRECTION);
+   bandwidth = vector<long long> (size * MAX_DIRECTION);
+   psudonode = vector<char> (size);
+   total = 0;
 }
 
 void Utilization::reset() {
-   for (int i = 0; i < size; i++) {
-      for (int j = 0; j < MAX_DIRECTION; j++) {
-         utilization[i][j].toNodeId = NO_NODE;
-         utilization[i][j].connection = 0;
-         utilization[i][j].bandwidth = 0;
-      }
+   fill(connection.begin(), connection.end(), 0);
+   fill(bandwidth.begin(), bandwidth.end(), 0);
+   fill(psudonode.begin(), psudonode.end(), false);
+   total = 0;
+}
+
+void Utilization::changeLink(int nodeId, int dir, int conn, long long bw) {
+   int link = nodeId * MAX_DIRECTION + dir;
+   /*
+    * remove the old contribution of the link from total
+    * and add the new one
+    */
+   if (psudonode[nodeId]) {
+      total -= connection[link] * bandwidth[link];
+   }
+   connection[link] += conn;
+   if (connection[link] == 0) {
+      //unused link
+      bandwidth[link] = 0;
+   } else {
+      bandwidth[link] += bw;
+   }
+   if (psudonode[nodeId]) {
+      total += connection[link] * bandwidth[link];
    }
 }
 
-void Utilization::addConnection(int nodeIdPrev, int dir, int nodeIdCur,
-      double bw) {
-   utilization[nodeIdPrev][dir].toNodeId = nodeIdCur;
-   utilization[nodeIdPrev][dir].connection++;
-   utilization[nodeIdPrev][dir].bandwidth += bw;
+void Utilization::setPsudonode(int nodeId, bool p) {
+   if ((bool) psudonode[nodeId] == p) {
+      return;
+   }
+   psudonode[nodeId] = p;
+   if (p) {
+      total += nodeUtil(nodeId);
+   } else {
+      total -= nodeUtil(nodeId);
+   }
 }
 
-double Utilization::calculateUtil() {
-   double util = 0;
-   for (int i = 0; i < (size); i++) {
-      for (int j = 0; j < MAX_DIRECTION; j++) {
-         if (utilization[i][j].toNodeId != NO_NODE) {
-            util += utilization[i][j].connection * utilization[i][j].bandwidth;
-         }
-      }
+long long Utilization::nodeUtil(int nodeId) const {
+   long long util = 0;
+   int link = nodeId * MAX_DIRECTION;
+   for (int j = 0; j < MAX_DIRECTION; j++) {
+      util += connection[link + j] * bandwidth[link + j];
    }
    return util;
 }
 
+double Utilization::getNodeUtil(int nodeId) const {
+   return psudonode[nodeId] ? (double) nodeUtil(nodeId) / scale
+         : 0;
+}
+
+int Utilization::getConnection(int nodeId, int dir) const {
+   return connection[nodeId * MAX_DIRECTION + dir];
+}
+
+long long Utilization::getBandwidth(int nodeId, int dir) const {
+   return bandwidth[nodeId * MAX_DIRECTION + dir];
+}
+
+double Utilization::getUtil() const {
+   return (double) total / scale;
+}
+
+long long Utilization::getFixedUtil() const {
+   return total;
+}
+
+long long Utilization::getScale() const {
+   return scale;
+}
+
+double Utilization::calculateUtil() {
+   long long util = 0;
+   int numLink = size * MAX_DIRECTION;
+   /*
+    * a single sweep over every link,
+    * links of nodes that are not psudonodes are masked out
+    */
+   for (int k = 0; k < numLink; k++) {
+      util += psudonode[k / MAX_DIRECTION] * (connection[k] * bandwidth[k]);
+   }
+   //resynchronize maintained utilization cost
+   total = util;
+   return getUtil();
+}
+
 double Utilization::getMaxBandwidth(int& nodeId, int& dir) const {
-   double max = 0;
-   for (int i = 0; i < size; i++) {
-      for (int j = 0; j < MAX_DIRECTION; j++) {
-         if (utilization[i][j].toNodeId != NO_NODE) {
-            if (utilization[i][j].bandwidth > max) {
-               max = utilization[i][j].bandwidth;
-               nodeId = i;
-               dir = j;
-            }
-         }
+   long long max = 0;
+   int numLink = size * MAX_DIRECTION;
+   for (int k = 0; k < numLink; k++) {
+      if (psudonode[k / MAX_DIRECTION] && connection[k] != 0
+            && bandwidth[k] > max) {
+         max = bandwidth[k];
+         nodeId = k / MAX_DIRECTION;
+         dir = k % MAX_DIRECTION;
       }
    }
-   return max;
+   return (double) max / scale;
 }
 
 void Utilization::printUtil() const {
@@ -71,15 +136,14 @@ void Utilization::printUtil() const {
    for (int i = 0; i < size; i++) {
       cout << setw(4) << i << " ";
       for (int j = 0; j < MAX_DIRECTION; j++) {
-         if (utilization[i][j].toNodeId != NO_NODE) {
-            cout << "<" << setw(2) << utilization[i][j].toNodeId << ","
-                  << setw(2) << utilization[i][j].connection << "," << setw(2)
-                  << utilization[i][j].bandwidth << ">";
+         if (psudonode[i] && getConnection(i, j) != 0) {
+            cout << "<" << setw(2) << getConnection(i, j) << ","
+                  << setw(2) << (double) getBandwidth(i, j) / scale
+                  << ">";
          } else {
-            cout << "           ";
+            cout << "        ";
          }
       }
       cout << endl;
    }
 }
-
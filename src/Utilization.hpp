@@ -7,22 +7,19 @@
 
 #define MAX_DIRECTION 4
 
-#define NO_NODE -1
-
 using std::vector;
 
-struct Link {
-   int toNodeId; //link to what nodeId
-   int connection; //number of connection in using this link
-   double bandwidth; //bandwidth going through this link
-
-   Link() { //constructor
-      toNodeId = NO_NODE;
-      connection = 0;
-      bandwidth = 0;
-   }
-};
-
+/*
+ * Utilization matrix
+ * A route is split into links at psudonodes. Every connection that goes
+ * through a psudonode starts a new link there, so the link starting from
+ * a psudonode in direction "dir" carries every connection that leaves the
+ * router in that direction.
+ * The matrix keeps connections and bandwidth leaving every router in every
+ * direction, and only links of psudonodes are counted in utilization cost.
+ * Links are stored in flat arrays, the link leaving "nodeId" in direction
+ * "dir" is at index nodeId * MAX_DIRECTION + dir.
+ */
 class Utilization {
    public:
       Utilization();
@@ -31,23 +28,52 @@ class Utilization {
       /*
        * initialize utilization matrix
        * allocate the memory
+       * bandwidth is in units of 1 / "scale"
        */
-      void init(int row, int col);
+      void init(int row, int col, long long scale = FIXED_POINT_SCALE);
       /*
        * set all element of the matrix to zero
        */
       void reset();
       /*
-       * calculate utilization cost
+       * calculate utilization cost by going through every link
        */
       double calculateUtil();
+      /*
+       * get utilization cost maintained by changeLink and setPsudonode
+       */
+      double getUtil() const;
+      /*
+       * same cost in units of 1 / scale
+       */
+      long long getFixedUtil() const;
+      /*
+       * get scale of the fixed point bandwidth
+       */
+      long long getScale() const;
       /*
        * Update utilization matrix
-       * This adds connection between 2 psudonodes.
-       * The connection starts from "nodeIdPrev" to "nodeIdCur"
-       * in direction "dir" with bandwidth "bw"
+       * Change number of connections leaving "nodeId" in direction "dir"
+       * by "conn" and their bandwidth by "bw"
+       * bandwidth is in units of 1 / scale
        */
-      void addConnection(int nodeIdPrev, int dir, int nodeIdCur, double bw);
+      void changeLink(int nodeId, int dir, int conn, long long bw);
+      /*
+       * set psudonode condition of "nodeId"
+       * links are counted only when the node is a psudonode
+       */
+      void setPsudonode(int nodeId, bool psudonode);
+      /*
+       * get number of connections and bandwidth of a link
+       * bandwidth is in units of 1 / scale
+       */
+      int getConnection(int nodeId, int dir) const;
+      long long getBandwidth(int nodeId, int dir) const;
+      /*
+       * get utilization cost of links leaving "nodeId"
+       * zero when the node is not a psudonode
+       */
+      double getNodeUtil(int nodeId) const;
       /*
        * Get the maximum bandwidth of a link in a network
        * nodeId is modified to nodeId of a utilization matrix
@@ -62,7 +88,27 @@ class Utilization {
 
    private:
       int size;
-      vector< vector<Link> > utilization;
+      long long scale;
+      /*
+       * number of connections using a link and bandwidth going through it
+       * bandwidth and total are kept in units of 1 / scale,
+       * so adding and removing routes never leaves rounding errors
+       */
+      vector<int> connection;
+      vector<long long> bandwidth;
+      /*
+       * psudonode condition of every node
+       */
+      vector<char> psudonode;
+      /*
+       * sum of connection * bandwidth of every link
+       */
+      long long total;
+
+      /*
+       * sum of connection * bandwidth of links leaving "nodeId"
+       */
+      long long nodeUtil(int nodeId) const;
 };
 
 #endif /* UTILIZATION_HPP_ */
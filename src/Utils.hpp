@@ -3,15 +3,13 @@
 
 #include "Defs.hpp"
 
-int getHops(Coordinate a, Coordinate b);
 /*
- * Generate uniform random number in [0,1] interval
+ * number of hops of an XY route from a to b
  */
-double uniform_0_1();
-/*
- * Generate uniform random number in [0,n) internal
- * This does not include n.
- */
-int uniform_n(int n);
+inline int getHops(Coordinate a, Coordinate b) {
+   int dx = a.x - b.x;
+   int dy = a.y - b.y;
+   return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
 
 #endif
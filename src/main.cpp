@@ -4,6 +4,8 @@
 #include <cstdlib>
 #include <sstream>
 #include <iomanip>
+#include <unistd.h>
+#include <stdint.h>
 
 #include "Defs.hpp"
 #include "Simulator.hpp"
@@ -24,6 +26,11 @@ void printUsage() {
          << "\t-c <value> : setting number of consecutive rejection per temperature (default = 200)\n"
          << "\t-p <value> : setting threshold of state accept per temperature (default = 100)\n"
          << "\t-n <value> : setting seed value for random number\n"
+         << "\t-f         : propose only positions that meet the latency constraints\n"
+         << "\t-l         : propose range-limited moves, shifts and neighbour swaps\n"
+         << "\t-w         : move mostly cores whose connections have a high cost\n"
+         << "\t-k <value> : recalculate cost every <value> accepted moves and report drift (default = 0, never)\n"
+         << "\t-t <value> : keep 2^<value> evaluated placements in a transposition table (default = 0, none)\n"
          << "\t-o <file>  : specify output of the simulation in an input format "
          << "that can be used as an input for next simulation\n"
          << "\t-v         : verbose printing\n"
@@ -47,6 +54,11 @@ int main(int argc, char* argv[]) {
    int accept = ACCEPT;
    bool verbose = false;
    bool quiet = false;
+   bool feasible = false;
+   bool range = false;
+   bool hot = false;
+   int check = 0;
+   int table = 0;
    char* inputfile = NULL;
    char* outfile = NULL;
    string outstr;
@@ -56,7 +68,7 @@ int main(int argc, char* argv[]) {
       return 0;
    }
 
-   while ((c = getopt(argc, argv, "a:b:g:d:s:e:r:i:c:p:n:hvqo:")) != -1) {
+   while ((c = getopt(argc, argv, "a:b:g:d:s:e:r:i:c:p:n:k:t:hvqflwo:")) != -1) {
       switch (c) {
       case 'a':
          alpha = atof(optarg);
@@ -97,6 +109,26 @@ int main(int argc, char* argv[]) {
       case 'q':
          quiet = true;
          break;
+      case 'f':
+         feasible = true;
+         break;
+      case 'l':
+         range = true;
+         break;
+      case 'w':
+         hot = true;
+         break;
+      case 'k':
+         check = atoi(optarg);
+         break;
+      case 't':
+         table = atoi(optarg);
+         if (table < 0 || table > MAX_TRANSPOSITION_BITS) {
+            cout << "# Transposition table must have 0 to "
+                  << MAX_TRANSPOSITION_BITS << " bits exit" << endl;
+            return 0;
+         }
+         break;
       case 'h':
          printUsage();
          return 0;
@@ -112,14 +144,16 @@ int main(int argc, char* argv[]) {
 
    inputfile = argv[optind];
 
-   srand(seed);
-
    /*
     * Initialize simulated annealing
     */
    Simulator sa;
-   int err = sa.init(alpha, beta, gamma, delta, start, end, rate, iter, reject,
-         accept, inputfile, verbose, quiet);
+   shared_ptr<Problem> problem(new Problem());
+   int err = problem->load(inputfile);
+   if (err == NO_ERR) {
+      err = sa.init(alpha, beta, gamma, delta, start, end, rate, iter, reject,
+            accept, problem, verbose, quiet);
+   }
 
    if (err == FILE_OPEN_ERR) {
       cout << "# File open error exit" << endl;
@@ -128,6 +162,25 @@ int main(int argc, char* argv[]) {
       cout << "# Illegal initial state" << endl;
       sa.printIllegalConnection();
       return 0;
+   } else if (err == INPUT_ERR) {
+      cout << "# Invalid input file exit" << endl;
+      return 0;
+   } else if (err == CONNECTION_ERR) {
+      cout << "# More than " << INT16_MAX << " connections exit" << endl;
+      return 0;
+   }
+   if (!problem->isBandwidthExact()) {
+      cerr << "# Bandwidth rounded to units of 1/"
+            << problem->getNetlist().getScale() << endl;
+   }
+   sa.setFeasibleMove(feasible);
+   sa.setRangeLimit(range);
+   sa.setHotCore(hot);
+   sa.setSeed(seed);
+   sa.setCheckInterval(check);
+   if (!sa.setTranspositionTable(table) && table > 0) {
+      cerr << "# Transposition table is not used without utilization cost"
+            << endl;
    }
 
    /*
@@ -158,6 +211,7 @@ int main(int argc, char* argv[]) {
       cout << endl;
       sa.printSummary();
       sa.printLatencyTable();
+      sa.printTranspositionTable();
    } else {
       stringstream s;
       s << seed << " ";